@@ -37,6 +37,14 @@
 *****************************************  IMPORTANT NOTE  **********************************/
 
 
+/*  We need _GNU_SOURCE on Linux for syscall, sendfile64, and friends.  This has to be set before any system header is
+    included.  */
+
+#if (defined __linux__) && !(defined _GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+
 /*  Try to handle some things for MSC and Mac OS/X.  Does it work?  Who knows, I don't have
     either platform.  */
 
@@ -51,12 +59,51 @@
 #define fseeko64(x, y, z) fseek((x), (y), (z))
 #define ftello64(x)       ftell((x))
 #define fopen64(x, y)     fopen((x), (y))
+#define pread64           pread
+#define pwrite64          pwrite
+#define off64_t           off_t
 #endif
 
 
 #include "libslas.h"
 #include "libslas_version.h"
 
+#ifndef NVWIN3X
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <sys/sendfile.h>
+#endif
+
+
+/*  The io_uring I/O engine (see libslas_set_io_engine) is only available on Linux.  We use the raw system calls so we don't
+    need liburing.  If your system doesn't have <linux/io_uring.h> define NO_IO_URING.  */
+
+#if !(defined __linux__) || !(defined __NR_io_uring_setup)
+#ifndef NO_IO_URING
+#define NO_IO_URING
+#endif
+#endif
+
+#ifndef NO_IO_URING
+#include <linux/io_uring.h>
+#endif
+
 
 #undef LIBSLAS_DEBUG
 #define LIBSLAS_DEBUG_OUTPUT stderr
@@ -79,24 +126,277 @@
 #define POINT_DATA_SIZE 34
 
 
-/*!  This is the structure we use to keep track of important formatting data for an open LAS file.  */
+/*  Size of the local buffer used for block I/O of point data records.  This has to be larger than the largest possible
+    point_data_record_length (65535).  */
+
+#define POINT_BLOCK_SIZE 65536
+
+
+/*  Buffered point data writes are cut off at multiples of this file position (except for the last one).  */
+
+#define WRITE_ALIGNMENT 4096
+
+
+/*  Address, length, and memory alignment for O_DIRECT reads (LIBSLAS_READONLY_DIRECT).  4096 works for 512 byte and 4K
+    sector devices.  */
+
+#define DIRECT_ALIGNMENT 4096
+
+
+/*  Read-ahead (see libslas_set_read_ahead) needs pthreads and pread so we don't do it on Windows.  Each read-ahead buffer is
+    split into READ_AHEAD_SLOTS blocks so that the read-ahead thread can be filling one or two while the application is
+    decoding another.  */
+
+#if (defined NVWIN3X) || (defined _MSC_VER)
+#define NO_READ_AHEAD
+#endif
+
+#define READ_AHEAD_SLOTS 3
+
+#define SLOT_EMPTY   0
+#define SLOT_LOADING 1
+#define SLOT_FULL    2
+
+
+/*  Maximum number of reads or writes that we hand to libslas_batch_io at one time.  This is also the size of the io_uring
+    submission queue.  */
+
+#define IO_BATCH_SIZE 256
+
+
+/*  One positional read or write for libslas_batch_io.  */
 
 typedef struct
 {
-  char              path[1024];                 /*!<  Fully qualified LAS file name.  */
-  FILE              *fp;                        /*!<  LAS file pointer.  */
-  LIBSLAS_HEADER    header;                     /*!<  LAS file header.  */
+  int64_t           addr;                       /*  Address in the file.  */
+  uint8_t           *buffer;                    /*  Data.  */
+  size_t            length;                     /*  Number of bytes.  */
+} IO_REQUEST;
+
+
+/*  Size of a VLR header in the file.  */
+
+#define VLR_HEADER_SIZE    54
+
+
+/*  One VLR directory entry (see libslas_read_vlr_directory).  */
+
+typedef struct
+{
+  int64_t            addr;                      /*  Address of the VLR header in the file.  */
+  LIBSLAS_VLR_HEADER header;                    /*  The VLR header.  */
+} VLR_ENTRY;
+
+
+/*  Size and modification time of a LAS file, saved in the sidecar files so we can tell when the LAS file has been changed
+    (see libslas_get_file_stamp).  */
+
+typedef struct
+{
+  int64_t           size;                       /*  File size in bytes.  */
+  int64_t           mtime_sec;                  /*  Modification time, seconds.  */
+  int64_t           mtime_nsec;                 /*  Modification time, nanoseconds (0 if the system doesn't have them).  */
+} FILE_STAMP;
+
+
+/*  Spatial index sidecar file (see libslas_build_spatial_index).  It's an INDEX_HEADER, then nx * ny + 1 int64_t indices
+    of the first run of each cell (row by row, the last one is the total number of runs), then the runs themselves (pairs of
+    int32_t first record number and number of records).  It's written in native byte order, if the magic number doesn't
+    match we just won't use it.  */
+
+#define INDEX_MAGIC           0x4c534932
+#define INDEX_POINTS_PER_CELL 4096
+#define INDEX_MAX_CELLS       1024
+
+typedef struct
+{
+  uint32_t          magic;                      /*  INDEX_MAGIC.  */
+  uint32_t          number_of_point_records;    /*  Number of point records in the LAS file when the index was built.  */
+  FILE_STAMP        stamp;                      /*  Size and modification time of the LAS file when the index was built.  */
+  double            min_x;                      /*  Bounds of the LAS file when the index was built (also the grid origin).  */
+  double            min_y;
+  double            max_x;
+  double            max_y;
+  double            cell_x;                     /*  Width of a grid cell.  */
+  double            cell_y;                     /*  Height of a grid cell.  */
+  int32_t           nx;                         /*  Number of columns in the grid.  */
+  int32_t           ny;                         /*  Number of rows in the grid.  */
+} INDEX_HEADER;
+
+
+/*  A run of consecutive records in one spatial index cell (only used while building the index).  */
+
+typedef struct
+{
+  int32_t           cell;                       /*  Grid cell.  */
+  int32_t           first;                      /*  First record number.  */
+  int32_t           count;                      /*  Number of records.  */
+} INDEX_RUN;
+
+
+/*  Number of point records summarized by each entry of the GPS time index (see libslas_query_time_window).  */
+
+#define TIME_CHUNK_SIZE 65536
+
+
+/*  Zone map sidecar file (see libslas_build_zone_map).  It's a ZONE_HEADER followed by one ZONE_ENTRY for every
+    ZONE_CHUNK_SIZE point records.  Like the spatial index it's written in native byte order.  */
+
+#define ZONE_MAGIC      0x4c535a32
+#define ZONE_CHUNK_SIZE 65536
+
+typedef struct
+{
+  uint32_t          magic;                      /*  ZONE_MAGIC.  */
+  uint32_t          number_of_point_records;    /*  Number of point records in the LAS file when the zone map was built.  */
+  FILE_STAMP        stamp;                      /*  Size and modification time of the LAS file when the zone map was built.  */
+  double            min_x;                      /*  Bounds of the LAS file when the zone map was built.  */
+  double            min_y;
+  double            min_z;
+  double            max_x;
+  double            max_y;
+  double            max_z;
+  int32_t           chunks;                     /*  Number of ZONE_ENTRY records.  */
+} ZONE_HEADER;
+
+
+/*  Summary of ZONE_CHUNK_SIZE consecutive point records.  */
+
+typedef struct
+{
+  int32_t           min[3];                     /*  Minimum raw (unscaled) X, Y, and Z.  */
+  int32_t           max[3];                     /*  Maximum raw (unscaled) X, Y, and Z.  */
+  uint32_t          classification;             /*  Bit n is set if any record has classification n.  */
+  uint16_t          min_intensity;
+  uint16_t          max_intensity;
+  uint8_t           return_number;              /*  Bit n is set if any record has return number n.  */
+} ZONE_ENTRY;
+
+
+#ifndef NO_IO_URING
+
+/*!  io_uring state for a LAS file (see libslas_set_io_engine).  The pointers point into the rings that we share with the
+     kernel.  The mutex keeps two threads from using the rings at the same time.  */
+
+typedef struct
+{
+  int32_t             fd;                       /*!<  io_uring file descriptor.  */
+  pthread_mutex_t     mutex;                    /*!<  Protects the rings.  */
+  uint8_t             *sq_map;                  /*!<  Submission queue ring mapping.  */
+  size_t              sq_map_size;              /*!<  Size of the submission queue ring mapping.  */
+  uint8_t             *cq_map;                  /*!<  Completion queue ring mapping (may be the same as sq_map).  */
+  size_t              cq_map_size;              /*!<  Size of the completion queue ring mapping.  */
+  struct io_uring_sqe *sqes;                    /*!<  Submission queue entries.  */
+  size_t              sqes_size;                /*!<  Size of the submission queue entries mapping.  */
+  uint32_t            *sq_head;                 /*!<  Submission queue head (moved by the kernel as it takes entries).  */
+  uint32_t            *sq_tail;                 /*!<  Submission queue tail.  */
+  uint32_t            *sq_mask;                 /*!<  Submission queue index mask.  */
+  uint32_t            *sq_array;                /*!<  Submission queue index array.  */
+  uint32_t            *cq_head;                 /*!<  Completion queue head.  */
+  uint32_t            *cq_tail;                 /*!<  Completion queue tail.  */
+  uint32_t            *cq_mask;                 /*!<  Completion queue index mask.  */
+  struct io_uring_cqe *cqes;                    /*!<  Completion queue entries.  */
+} URING_STRUCT;
+
+#endif
+
+
+#ifndef NO_READ_AHEAD
+
+/*!  Read-ahead state for a LAS file.  Everything except the read-ahead thread's own copy of the slot addresses is protected
+     by the mutex.  */
+
+typedef struct
+{
+  pthread_t         thread;                     /*!<  The read-ahead thread.  */
+  pthread_mutex_t   mutex;                      /*!<  Protects the rest of the structure.  */
+  pthread_cond_t    cond;                       /*!<  Signaled whenever a slot changes state or the application wants something.  */
+  uint8_t           *slot[READ_AHEAD_SLOTS];    /*!<  Start of each slot in the application supplied buffer.  */
+  int32_t           first[READ_AHEAD_SLOTS];    /*!<  First record number in each slot.  */
+  int32_t           count[READ_AHEAD_SLOTS];    /*!<  Number of records in each slot.  */
+  uint32_t          slot_generation[READ_AHEAD_SLOTS]; /*!<  Value of generation when the slot was started.  */
+  uint8_t           state[READ_AHEAD_SLOTS];    /*!<  SLOT_EMPTY, SLOT_LOADING, or SLOT_FULL.  */
+  int32_t           slot_records;               /*!<  Number of records that fit in a slot.  */
+  int32_t           next;                       /*!<  Next record number the read-ahead thread will read.  */
+  uint32_t          generation;                 /*!<  Incremented whenever the application jumps somewhere we didn't read ahead.  */
+  uint8_t           stop;                       /*!<  Set to tell the read-ahead thread to quit.  */
+  uint8_t           paused;                     /*!<  Set if the application said it's reading randomly (see libslas_advise).  */
+} READ_AHEAD_STRUCT;
+
+#endif
+
+
+/*  Running statistics for a block of raw point data records (see libslas_scan_raw_point_data).  */
+
+typedef struct
+{
+  int32_t           min[3];                     /*!<  Minimum raw X, Y, and Z integers.  */
+  int32_t           max[3];                     /*!<  Maximum raw X, Y, and Z integers.  */
+  uint32_t          number_of_points_by_return[5]; /*!<  Number of points by return.  */
+  int64_t           count;                      /*!<  Number of records scanned.  */
+} RAW_POINT_STATS;
+
+
+/*!  This is the structure we use to keep track of important formatting data for an open LAS file.  Only the things we
+     need for point data I/O are in here, anything that's only used when opening, closing, or reporting an error is in the
+     INTERNAL_LIBSLAS_COLD_STRUCT so it doesn't take up cache space.  */
+
+typedef struct
+{
+  int32_t           fd;                         /*!<  File descriptor of fp, used for all point data I/O.  */
+  int32_t           direct_fd;                  /*!<  O_DIRECT file descriptor used for point data reads (LIBSLAS_READONLY_DIRECT), otherwise 0.  */
+  int32_t           mode;                       /*!<  File open mode (LIBSLAS_UPDATE, LIBSLAS_READONLY, LIBSLAS_READONLY_MMAP, LIBSLAS_READONLY_DIRECT,
+                                                          LIBSLAS_APPEND).  */
   uint8_t           swap;                       /*!<  Set to 1 on big endian systems.  */
-  uint8_t           at_end;                     /*!<  Set if the LAS file position is at the end of the file.  */
+  uint8_t           at_end;                     /*!<  Set if the stdio file position is at the end of the file.  */
   uint8_t           created;                    /*!<  Set if we created the LAS file.  */
+  uint8_t           append;                     /*!<  Set if an existing LAS file was opened LIBSLAS_APPEND.  */
   uint8_t           modified;                   /*!<  Set if the LAS file header has been modified.  */
   uint8_t           write;                      /*!<  Set if the last action to the LAS file was a write.  */
-  int32_t           mode;                       /*!<  File open mode (LIBSLAS_UPDATE, LIBSLAS_READONLY, LIBSLAS_READONLY_SEQUENTIAL).  */
   uint8_t           data;                       /*!<  Set if a point data record has been written to a new file (to test for VLR writing).  */
-  int64_t           pos;                        /*!<  Position of the LAS file pointer after last I/O operation.  */
+  uint8_t           parallel;                   /*!<  Set if the point count was declared (see libslas_declare_point_count).  */
+  int32_t           declared;                   /*!<  Declared number of point records.  */
+  uint8_t           *points;                    /*!<  Address of the first point data record in the memory mapped region.  */
+  int64_t           pos;                        /*!<  File position at which the next point data record will be appended.  */
+  uint8_t           *buffer;                    /*!<  Application supplied I/O buffer (see libslas_set_io_buffer), otherwise NULL.  */
+  int32_t           buffer_size;                /*!<  Size of the application supplied I/O buffer.  */
+  int32_t           buffer_used;                /*!<  Number of bytes of point data waiting in the I/O buffer.  */
+  FILE              *fp;                        /*!<  LAS file pointer (NULL if the handle isn't in use).  */
+  void              *ra;                        /*!<  Read-ahead state (READ_AHEAD_STRUCT in the cold structure) or NULL.  */
+  void              *uring;                     /*!<  io_uring state (URING_STRUCT in the cold structure) or NULL.  */
+  LIBSLAS_HEADER    header;                     /*!<  LAS file header.  */
 } INTERNAL_LIBSLAS_STRUCT;
 
 
+/*!  The rarely used parts of an open LAS file's information.  */
+
+typedef struct
+{
+  char              path[1024];                 /*!<  Fully qualified LAS file name.  */
+  uint8_t           *map;                       /*!<  Start of the memory mapped region (LIBSLAS_READONLY_MMAP), otherwise NULL.  */
+  size_t            map_size;                   /*!<  Size of the memory mapped region.  */
+  int32_t           next_free;                  /*!<  Next handle in the free list (only meaningful while the handle is free).  */
+#ifndef NO_READ_AHEAD
+  READ_AHEAD_STRUCT read_ahead;                 /*!<  Read-ahead state (see libslas_set_read_ahead).  */
+#endif
+#ifndef NO_IO_URING
+  URING_STRUCT      uring;                      /*!<  io_uring state (see libslas_set_io_engine).  */
+#endif
+#ifdef _MSC_VER
+  SRWLOCK           stats_lock;                 /*!<  Protects stats.  */
+#else
+  pthread_mutex_t   stats_lock;                 /*!<  Protects stats.  */
+#endif
+  RAW_POINT_STATS   stats;                      /*!<  Statistics of the records written with libslas_write_point_data.  */
+  int64_t           prealloc;                   /*!<  Size the file was preallocated to (see libslas_create_las_file_hint), otherwise 0.  */
+  VLR_ENTRY         *vlr;                       /*!<  The VLR headers and their addresses, or NULL.  */
+  int32_t           vlr_count;                  /*!<  Number of entries in vlr.  */
+  double            *time_index;                /*!<  Minimum and maximum GPS time of each TIME_CHUNK_SIZE records, or NULL.  */
+  uint32_t          time_count;                 /*!<  Number of point records when time_index was built.  */
+  uint8_t           time_sorted;                /*!<  Set if the records were in GPS time order when time_index was built.  */
+} INTERNAL_LIBSLAS_COLD_STRUCT;
+
+
 /*  LIBSLAS error handling structure definition.  */
 
 typedef struct 
@@ -106,18 +406,109 @@ typedef struct
 } LIBSLAS_ERROR_STRUCT;
 
 
-/*!  This is where we'll store the headers and formatting/usage information of all open LIBSLAS files.  */
+/*  libslas_parallel_scan hands out SCAN_BATCH_SIZE records at a time to each worker thread.  The decoded batch lives on the
+    worker's stack so we ask for SCAN_STACK_SIZE bytes of stack (the batch plus plenty for libslas_read_point_data_range).
+    Like read-ahead, this needs pthreads and pread so on Windows we just scan in the calling thread.  */
+
+#define SCAN_BATCH_SIZE  4096
+#define SCAN_STACK_SIZE  (SCAN_BATCH_SIZE * sizeof (LIBSLAS_POINT_DATA) + 1024 * 1024)
+#define SCAN_MAX_THREADS 256
+
+#if (defined NVWIN3X) || (defined _MSC_VER)
+#define NO_PARALLEL_SCAN
+#endif
+
+
+#ifndef NO_PARALLEL_SCAN
+
+/*  State shared by the libslas_parallel_scan worker threads.  Everything after the mutex is protected by it.  */
+
+typedef struct
+{
+  int32_t               hnd;                    /*  The file handle (shared by all of the workers).  */
+  int32_t               num_recs;               /*  Number of point records in the file.  */
+  LIBSLAS_SCAN_CALLBACK callback;               /*  The application's callback.  */
+  void                  *user_ctx;              /*  The application's context pointer.  */
+  pthread_mutex_t       mutex;                  /*  Protects the rest of the structure.  */
+  int32_t               next;                   /*  First record of the next batch to hand out.  */
+  uint8_t               stop;                   /*  Set when the callback asks us to stop or something fails.  */
+  LIBSLAS_ERROR_STRUCT  error;                  /*  The first error any of the workers ran into.  */
+} SCAN_STRUCT;
+
+
+/*  What each worker thread gets handed.  */
+
+typedef struct
+{
+  SCAN_STRUCT           *scan;                  /*  The shared state.  */
+  int32_t               thread;                 /*  Worker number (0 to nthreads - 1) passed to the callback.  */
+} SCAN_WORKER;
+
+#endif
+
+
+/*!  This is where we'll store the headers and formatting/usage information of all open LIBSLAS files.  The handle table is
+     allocated LIBSLAS_CHUNK_SIZE handles at a time as needed.  Chunks are never moved or freed so a thread can use its handle
+     without locking while other threads are opening and closing files.  Use LAS (hnd) and LAS_COLD (hnd) to get at a handle's
+     information.  */
+
+#define LIBSLAS_CHUNK_SHIFT 6
+#define LIBSLAS_CHUNK_SIZE  (1 << LIBSLAS_CHUNK_SHIFT)
+#define LIBSLAS_MAX_CHUNKS  (LIBSLAS_MAX_FILES / LIBSLAS_CHUNK_SIZE)
 
-static INTERNAL_LIBSLAS_STRUCT las[LIBSLAS_MAX_FILES];
+static INTERNAL_LIBSLAS_STRUCT *las[LIBSLAS_MAX_CHUNKS];
+static INTERNAL_LIBSLAS_COLD_STRUCT *las_cold[LIBSLAS_MAX_CHUNKS];
 
+#define LAS(h)      (las[(h) >> LIBSLAS_CHUNK_SHIFT][(h) & (LIBSLAS_CHUNK_SIZE - 1)])
+#define LAS_COLD(h) (las_cold[(h) >> LIBSLAS_CHUNK_SHIFT][(h) & (LIBSLAS_CHUNK_SIZE - 1)])
 
-/*!  This is where we'll store error information in the event of some kind of screwup.  */
 
-static LIBSLAS_ERROR_STRUCT libslas_error;
+/*!  Number of allocated chunks and the head of the free handle list (-1 if there are no free handles).  Both, along with
+     the startup flag below, are protected by las_lock.  */
 
+static int32_t las_chunks = 0;
+static int32_t las_free = -1;
 
-/*!  Startup flag used by either libslas_create_las_file or libslas_open_las_file to initialize the internal struct arrays and
-     set the SIGINT handler.  */
+#ifdef _MSC_VER
+static SRWLOCK las_lock = SRWLOCK_INIT;
+#define LIBSLAS_LOCK()   AcquireSRWLockExclusive (&las_lock)
+#define LIBSLAS_UNLOCK() ReleaseSRWLockExclusive (&las_lock)
+#else
+static pthread_mutex_t las_lock = PTHREAD_MUTEX_INITIALIZER;
+#define LIBSLAS_LOCK()   pthread_mutex_lock (&las_lock)
+#define LIBSLAS_UNLOCK() pthread_mutex_unlock (&las_lock)
+#endif
+
+
+/*  Per handle lock used to merge the statistics of records written by different threads (see libslas_write_point_data).  */
+
+#ifdef _MSC_VER
+#define LIBSLAS_STATS_INIT(h)    InitializeSRWLock (&LAS_COLD (h).stats_lock)
+#define LIBSLAS_STATS_DESTROY(h)
+#define LIBSLAS_STATS_LOCK(h)    AcquireSRWLockExclusive (&LAS_COLD (h).stats_lock)
+#define LIBSLAS_STATS_UNLOCK(h)  ReleaseSRWLockExclusive (&LAS_COLD (h).stats_lock)
+#else
+#define LIBSLAS_STATS_INIT(h)    pthread_mutex_init (&LAS_COLD (h).stats_lock, NULL)
+#define LIBSLAS_STATS_DESTROY(h) pthread_mutex_destroy (&LAS_COLD (h).stats_lock)
+#define LIBSLAS_STATS_LOCK(h)    pthread_mutex_lock (&LAS_COLD (h).stats_lock)
+#define LIBSLAS_STATS_UNLOCK(h)  pthread_mutex_unlock (&LAS_COLD (h).stats_lock)
+#endif
+
+
+/*!  This is where we'll store error information in the event of some kind of screwup.  Each thread gets its own copy so
+     that threads working with different files don't stomp on each other's error messages.  Nothing writes to it unless
+     something goes wrong.  */
+
+#ifdef _MSC_VER
+#define LIBSLAS_TLS __declspec(thread)
+#else
+#define LIBSLAS_TLS __thread
+#endif
+
+static LIBSLAS_TLS LIBSLAS_ERROR_STRUCT libslas_error;
+
+
+/*!  Startup flag used by libslas_get_handle to set the SIGINT handler.  */
 
 static uint8_t first = 1;
 
@@ -127,6 +518,157 @@ static uint8_t first = 1;
 #include "libslas_pd_functions.h"
 
 
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_get_handle
+
+ - Purpose:     Gets a free LIBSLAS file handle from the handle table, growing the table if
+                needed, and clears the internal structures for that handle.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - void
+
+ - Returns:
+                - The new LIBSLAS file handle
+                - LIBSLAS_TOO_MANY_OPEN_FILES_ERROR
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+
+ - Caveats:     This is the only place where the API allocates memory.  The chunks of the
+                handle table are never freed or moved so a handle that has been handed out
+                can be used without holding las_lock.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_get_handle ()
+{
+  int32_t i, hnd, chunk;
+
+
+  LIBSLAS_LOCK ();
+
+
+  /*  The first time through we want to set up the SIGINT handler.  */
+
+  if (first)
+    {
+      signal (SIGINT, libslas_sigint_handler);
+
+      first = 0;
+    }
+
+
+  /*  If there are no free handles, add a chunk to the table.  */
+
+  if (las_free < 0)
+    {
+      if (las_chunks == LIBSLAS_MAX_CHUNKS)
+        {
+          LIBSLAS_UNLOCK ();
+
+          sprintf (libslas_error.info, _("Too many LIBSLAS files are already open.\nFunction: %s, Line: %d\n"),
+                   __FUNCTION__, __LINE__ - 5);
+          return (libslas_error.libslas = LIBSLAS_TOO_MANY_OPEN_FILES_ERROR);
+        }
+
+
+      chunk = las_chunks;
+
+      las[chunk] = (INTERNAL_LIBSLAS_STRUCT *) calloc (LIBSLAS_CHUNK_SIZE, sizeof (INTERNAL_LIBSLAS_STRUCT));
+      las_cold[chunk] = (INTERNAL_LIBSLAS_COLD_STRUCT *) calloc (LIBSLAS_CHUNK_SIZE, sizeof (INTERNAL_LIBSLAS_COLD_STRUCT));
+
+      if (las[chunk] == NULL || las_cold[chunk] == NULL)
+        {
+          free (las[chunk]);
+          free (las_cold[chunk]);
+          las[chunk] = NULL;
+          las_cold[chunk] = NULL;
+
+          LIBSLAS_UNLOCK ();
+
+          sprintf (libslas_error.info, _("Unable to allocate memory for the LIBSLAS handle table :\n%s\nFunction: %s, Line: %d\n"), strerror (errno),
+                   __FUNCTION__, __LINE__ - 10);
+          return (libslas_error.libslas = LIBSLAS_MEMORY_ALLOCATION_ERROR);
+        }
+
+
+      /*  Put the new handles in the free list so that the lowest one comes out first.  */
+
+      for (i = LIBSLAS_CHUNK_SIZE - 1 ; i >= 0 ; i--)
+        {
+          las_cold[chunk][i].next_free = las_free;
+          las_free = chunk * LIBSLAS_CHUNK_SIZE + i;
+        }
+
+      las_chunks++;
+    }
+
+
+  hnd = las_free;
+  las_free = LAS_COLD (hnd).next_free;
+
+
+  LIBSLAS_UNLOCK ();
+
+
+  memset (&LAS (hnd), 0, sizeof (INTERNAL_LIBSLAS_STRUCT));
+  memset (&LAS_COLD (hnd), 0, sizeof (INTERNAL_LIBSLAS_COLD_STRUCT));
+
+
+  return (hnd);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_release_handle
+
+ - Purpose:     Clears the internal structures for a LIBSLAS file handle and puts it back in
+                the free list.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+
+ - Returns:
+                - void
+
+ - Caveats:     The file must already be closed.  This also frees the VLR directory.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_release_handle (int32_t hnd)
+{
+  free (LAS_COLD (hnd).vlr);
+
+  memset (&LAS (hnd), 0, sizeof (INTERNAL_LIBSLAS_STRUCT));
+  memset (&LAS_COLD (hnd), 0, sizeof (INTERNAL_LIBSLAS_COLD_STRUCT));
+
+
+  LIBSLAS_LOCK ();
+
+  LAS_COLD (hnd).next_free = las_free;
+  las_free = hnd;
+
+  LIBSLAS_UNLOCK ();
+}
+
+
 /********************************************************************************************/
 /*!
 
@@ -153,32 +695,32 @@ static void libslas_swap_las_header (int32_t hnd)
 {
   int16_t i;
 
-  libslas_swap_uint16_t (&las[hnd].header.global_encoding);
-  libslas_swap_uint32_t (&las[hnd].header.GUID_data_1);
-  libslas_swap_uint16_t (&las[hnd].header.GUID_data_2);
-  libslas_swap_uint16_t (&las[hnd].header.GUID_data_3);
-  libslas_swap_uint16_t (&las[hnd].header.file_creation_DOY);
-  libslas_swap_uint16_t (&las[hnd].header.file_creation_year);
-  libslas_swap_uint16_t (&las[hnd].header.header_size);
-  libslas_swap_uint32_t (&las[hnd].header.offset_to_point_data);
-  libslas_swap_uint32_t (&las[hnd].header.number_of_VLRs);
-  libslas_swap_uint16_t (&las[hnd].header.point_data_record_length);
-  libslas_swap_uint32_t (&las[hnd].header.number_of_point_records);
-
-  for (i = 0 ; i < 5 ; i++) libslas_swap_uint32_t (&las[hnd].header.number_of_points_by_return[i]);
-
-  libslas_swap_double (&las[hnd].header.x_scale_factor);
-  libslas_swap_double (&las[hnd].header.y_scale_factor);
-  libslas_swap_double (&las[hnd].header.z_scale_factor);
-  libslas_swap_double (&las[hnd].header.x_offset);
-  libslas_swap_double (&las[hnd].header.y_offset);
-  libslas_swap_double (&las[hnd].header.z_offset);
-  libslas_swap_double (&las[hnd].header.max_x);
-  libslas_swap_double (&las[hnd].header.min_x);
-  libslas_swap_double (&las[hnd].header.max_y);
-  libslas_swap_double (&las[hnd].header.min_y);
-  libslas_swap_double (&las[hnd].header.max_z);
-  libslas_swap_double (&las[hnd].header.min_z);
+  libslas_swap_uint16_t (&LAS (hnd).header.global_encoding);
+  libslas_swap_uint32_t (&LAS (hnd).header.GUID_data_1);
+  libslas_swap_uint16_t (&LAS (hnd).header.GUID_data_2);
+  libslas_swap_uint16_t (&LAS (hnd).header.GUID_data_3);
+  libslas_swap_uint16_t (&LAS (hnd).header.file_creation_DOY);
+  libslas_swap_uint16_t (&LAS (hnd).header.file_creation_year);
+  libslas_swap_uint16_t (&LAS (hnd).header.header_size);
+  libslas_swap_uint32_t (&LAS (hnd).header.offset_to_point_data);
+  libslas_swap_uint32_t (&LAS (hnd).header.number_of_VLRs);
+  libslas_swap_uint16_t (&LAS (hnd).header.point_data_record_length);
+  libslas_swap_uint32_t (&LAS (hnd).header.number_of_point_records);
+
+  for (i = 0 ; i < 5 ; i++) libslas_swap_uint32_t (&LAS (hnd).header.number_of_points_by_return[i]);
+
+  libslas_swap_double (&LAS (hnd).header.x_scale_factor);
+  libslas_swap_double (&LAS (hnd).header.y_scale_factor);
+  libslas_swap_double (&LAS (hnd).header.z_scale_factor);
+  libslas_swap_double (&LAS (hnd).header.x_offset);
+  libslas_swap_double (&LAS (hnd).header.y_offset);
+  libslas_swap_double (&LAS (hnd).header.z_offset);
+  libslas_swap_double (&LAS (hnd).header.max_x);
+  libslas_swap_double (&LAS (hnd).header.min_x);
+  libslas_swap_double (&LAS (hnd).header.max_y);
+  libslas_swap_double (&LAS (hnd).header.min_y);
+  libslas_swap_double (&LAS (hnd).header.max_z);
+  libslas_swap_double (&LAS (hnd).header.min_z);
 }
 
 
@@ -226,9 +768,9 @@ static int32_t libslas_write_header (int32_t hnd)
 
   /*  Position to the beginning of the file.  */
 
-  if (fseeko64 (las[hnd].fp, 0LL, SEEK_SET) < 0)
+  if (fseeko64 (LAS (hnd).fp, 0LL, SEEK_SET) < 0)
     {
-      sprintf (libslas_error.info, _("File : %s\nError during fseek prior to writing LAS header :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
+      sprintf (libslas_error.info, _("File : %s\nError during fseek prior to writing LAS header :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
                __FUNCTION__, __LINE__ - 3);
       return (libslas_error.libslas = LIBSLAS_HEADER_WRITE_FSEEK_ERROR);
     }
@@ -236,65 +778,67 @@ static int32_t libslas_write_header (int32_t hnd)
 
   /*  Save the header size bfore we swap it (maybe).  */
 
-  hdr_size = las[hnd].header.header_size;
+  hdr_size = LAS (hnd).header.header_size;
 
 
   /*  Swap the fields in the header that need to be swapped on a big endian system.  */
 
-  if (las[hnd].swap) libslas_swap_las_header (hnd);
+  if (LAS (hnd).swap) libslas_swap_las_header (hnd);
 
 
   /*  Fill the header buffer with data.  */
 
   pos = 0;
   sprintf ((char *) &header_data[pos], "LASF"); pos += 4;
-  memcpy (&header_data[pos], &las[hnd].header.file_source_id, 2); pos += 2;
-  memcpy (&header_data[pos], &las[hnd].header.global_encoding, 2); pos += 2;
-  memcpy (&header_data[pos], &las[hnd].header.GUID_data_1, 4); pos += 4;
-  memcpy (&header_data[pos], &las[hnd].header.GUID_data_2, 2); pos += 2;
-  memcpy (&header_data[pos], &las[hnd].header.GUID_data_3, 2); pos += 2;
-  memcpy (&header_data[pos], &las[hnd].header.GUID_data_4, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.version_major, 1); pos += 1;
-  memcpy (&header_data[pos], &las[hnd].header.version_minor, 1); pos += 1;
-  memcpy (&header_data[pos], &las[hnd].header.system_id, 32); pos += 32;
-  memcpy (&header_data[pos], &las[hnd].header.generating_software, 32); pos += 32;
-  memcpy (&header_data[pos], &las[hnd].header.file_creation_DOY, 2); pos += 2;
-  memcpy (&header_data[pos], &las[hnd].header.file_creation_year, 2); pos += 2;
-  memcpy (&header_data[pos], &las[hnd].header.header_size, 2); pos += 2;
-  memcpy (&header_data[pos], &las[hnd].header.offset_to_point_data, 4); pos += 4;
-  memcpy (&header_data[pos], &las[hnd].header.number_of_VLRs, 4); pos += 4;
-  memcpy (&header_data[pos], &las[hnd].header.point_data_format_id, 1); pos += 1;
-  memcpy (&header_data[pos], &las[hnd].header.point_data_record_length, 2); pos += 2;
-  memcpy (&header_data[pos], &las[hnd].header.number_of_point_records, 4); pos += 4;
+  memcpy (&header_data[pos], &LAS (hnd).header.file_source_id, 2); pos += 2;
+  memcpy (&header_data[pos], &LAS (hnd).header.global_encoding, 2); pos += 2;
+  memcpy (&header_data[pos], &LAS (hnd).header.GUID_data_1, 4); pos += 4;
+  memcpy (&header_data[pos], &LAS (hnd).header.GUID_data_2, 2); pos += 2;
+  memcpy (&header_data[pos], &LAS (hnd).header.GUID_data_3, 2); pos += 2;
+  memcpy (&header_data[pos], &LAS (hnd).header.GUID_data_4, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.version_major, 1); pos += 1;
+  memcpy (&header_data[pos], &LAS (hnd).header.version_minor, 1); pos += 1;
+  memcpy (&header_data[pos], &LAS (hnd).header.system_id, 32); pos += 32;
+  memcpy (&header_data[pos], &LAS (hnd).header.generating_software, 32); pos += 32;
+  memcpy (&header_data[pos], &LAS (hnd).header.file_creation_DOY, 2); pos += 2;
+  memcpy (&header_data[pos], &LAS (hnd).header.file_creation_year, 2); pos += 2;
+  memcpy (&header_data[pos], &LAS (hnd).header.header_size, 2); pos += 2;
+  memcpy (&header_data[pos], &LAS (hnd).header.offset_to_point_data, 4); pos += 4;
+  memcpy (&header_data[pos], &LAS (hnd).header.number_of_VLRs, 4); pos += 4;
+  memcpy (&header_data[pos], &LAS (hnd).header.point_data_format_id, 1); pos += 1;
+  memcpy (&header_data[pos], &LAS (hnd).header.point_data_record_length, 2); pos += 2;
+  memcpy (&header_data[pos], &LAS (hnd).header.number_of_point_records, 4); pos += 4;
   for (i = 0 ; i < 5 ; i++)
     {
-      memcpy (&header_data[pos], &las[hnd].header.number_of_points_by_return[i], 4);
+      memcpy (&header_data[pos], &LAS (hnd).header.number_of_points_by_return[i], 4);
       pos += 4;
     }
-  memcpy (&header_data[pos], &las[hnd].header.x_scale_factor, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.y_scale_factor, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.z_scale_factor, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.x_offset, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.y_offset, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.z_offset, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.max_x, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.min_x, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.max_y, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.min_y, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.max_z, 8); pos += 8;
-  memcpy (&header_data[pos], &las[hnd].header.min_z, 8); pos += 8;
-
-
-  if (!fwrite (header_data, hdr_size, 1, las[hnd].fp))
+  memcpy (&header_data[pos], &LAS (hnd).header.x_scale_factor, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.y_scale_factor, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.z_scale_factor, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.x_offset, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.y_offset, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.z_offset, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.max_x, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.min_x, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.max_y, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.min_y, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.max_z, 8); pos += 8;
+  memcpy (&header_data[pos], &LAS (hnd).header.min_z, 8); pos += 8;
+
+
+  /*  If the file has a longer header than ours (i.e. we're appending to it) leave the rest of it alone.  */
+
+  if (!fwrite (header_data, MIN (hdr_size, LIBSLAS_HEADER_SIZE), 1, LAS (hnd).fp))
     {
-      sprintf (libslas_error.info, _("File : %s\nError writing LAS header :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
+      sprintf (libslas_error.info, _("File : %s\nError writing LAS header :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
                __FUNCTION__, __LINE__ - 3);
       return (libslas_error.libslas = LIBSLAS_HEADER_WRITE_ERROR);
     }
 
 
-  las[hnd].write = 1;
-  las[hnd].pos = ftello64 (las[hnd].fp);
+  LAS (hnd).write = 1;
+  LAS (hnd).pos = ftello64 (LAS (hnd).fp);
 
 
 #ifdef LIBSLAS_DEBUG
@@ -303,7 +847,7 @@ static int32_t libslas_write_header (int32_t hnd)
 #endif
 
 
-  return (libslas_error.libslas = LIBSLAS_SUCCESS);
+  return (LIBSLAS_SUCCESS);
 }
 
 
@@ -356,17 +900,17 @@ static int32_t libslas_read_header (int32_t hnd)
 
   /*  Position to the beginning of the file.  */
 
-  if (fseeko64 (las[hnd].fp, 0LL, SEEK_SET) < 0)
+  if (fseeko64 (LAS (hnd).fp, 0LL, SEEK_SET) < 0)
     {
-      sprintf (libslas_error.info, _("File : %s\nError during fseek prior to reading LAS header :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
+      sprintf (libslas_error.info, _("File : %s\nError during fseek prior to reading LAS header :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
                __FUNCTION__, __LINE__ - 3);
       return (libslas_error.libslas = LIBSLAS_HEADER_READ_FSEEK_ERROR);
     }
 
 
-  if (!fread (header_data, LIBSLAS_HEADER_SIZE, 1, las[hnd].fp))
+  if (!fread (header_data, LIBSLAS_HEADER_SIZE, 1, LAS (hnd).fp))
     {
-      sprintf (libslas_error.info, _("File : %s\nError reading LAS header :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
+      sprintf (libslas_error.info, _("File : %s\nError reading LAS header :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
                __FUNCTION__, __LINE__ - 3);
       return (libslas_error.libslas = LIBSLAS_HEADER_READ_ERROR);
     }
@@ -376,7 +920,7 @@ static int32_t libslas_read_header (int32_t hnd)
 
   if (strncmp ((char *) header_data, "LASF", 4))
     {
-      sprintf (libslas_error.info, _("File : %s\nThis is not a LAS file.\nFunction: %s, Line: %d\n"), las[hnd].path,
+      sprintf (libslas_error.info, _("File : %s\nThis is not a LAS file.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
                __FUNCTION__, __LINE__ - 3);
       return (libslas_error.libslas = LIBSLAS_NOT_LAS_FILE_ERROR);
     }
@@ -385,60 +929,60 @@ static int32_t libslas_read_header (int32_t hnd)
   /*  Fill the header buffer with data.  */
 
   pos = 4;
-  memcpy (&las[hnd].header.file_source_id, &header_data[pos], 2); pos += 2;
-  memcpy (&las[hnd].header.global_encoding, &header_data[pos], 2); pos += 2;
-  memcpy (&las[hnd].header.GUID_data_1, &header_data[pos], 4); pos += 4;
-  memcpy (&las[hnd].header.GUID_data_2, &header_data[pos], 2); pos += 2;
-  memcpy (&las[hnd].header.GUID_data_3, &header_data[pos], 2); pos += 2;
-  memcpy (&las[hnd].header.GUID_data_4, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.version_major, &header_data[pos], 1); pos += 1;
-  memcpy (&las[hnd].header.version_minor, &header_data[pos], 1); pos += 1;
-  memcpy (&las[hnd].header.system_id, &header_data[pos], 32); pos += 32;
-  memcpy (&las[hnd].header.generating_software, &header_data[pos], 32); pos += 32;
-  memcpy (&las[hnd].header.file_creation_DOY, &header_data[pos], 2); pos += 2;
-  memcpy (&las[hnd].header.file_creation_year, &header_data[pos], 2); pos += 2;
-  memcpy (&las[hnd].header.header_size, &header_data[pos], 2); pos += 2;
-  memcpy (&las[hnd].header.offset_to_point_data, &header_data[pos], 4); pos += 4;
-  memcpy (&las[hnd].header.number_of_VLRs, &header_data[pos], 4); pos += 4;
-  memcpy (&las[hnd].header.point_data_format_id, &header_data[pos], 1); pos += 1;
-  memcpy (&las[hnd].header.point_data_record_length, &header_data[pos], 2); pos += 2;
-  memcpy (&las[hnd].header.number_of_point_records, &header_data[pos], 4); pos += 4;
+  memcpy (&LAS (hnd).header.file_source_id, &header_data[pos], 2); pos += 2;
+  memcpy (&LAS (hnd).header.global_encoding, &header_data[pos], 2); pos += 2;
+  memcpy (&LAS (hnd).header.GUID_data_1, &header_data[pos], 4); pos += 4;
+  memcpy (&LAS (hnd).header.GUID_data_2, &header_data[pos], 2); pos += 2;
+  memcpy (&LAS (hnd).header.GUID_data_3, &header_data[pos], 2); pos += 2;
+  memcpy (&LAS (hnd).header.GUID_data_4, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.version_major, &header_data[pos], 1); pos += 1;
+  memcpy (&LAS (hnd).header.version_minor, &header_data[pos], 1); pos += 1;
+  memcpy (&LAS (hnd).header.system_id, &header_data[pos], 32); pos += 32;
+  memcpy (&LAS (hnd).header.generating_software, &header_data[pos], 32); pos += 32;
+  memcpy (&LAS (hnd).header.file_creation_DOY, &header_data[pos], 2); pos += 2;
+  memcpy (&LAS (hnd).header.file_creation_year, &header_data[pos], 2); pos += 2;
+  memcpy (&LAS (hnd).header.header_size, &header_data[pos], 2); pos += 2;
+  memcpy (&LAS (hnd).header.offset_to_point_data, &header_data[pos], 4); pos += 4;
+  memcpy (&LAS (hnd).header.number_of_VLRs, &header_data[pos], 4); pos += 4;
+  memcpy (&LAS (hnd).header.point_data_format_id, &header_data[pos], 1); pos += 1;
+  memcpy (&LAS (hnd).header.point_data_record_length, &header_data[pos], 2); pos += 2;
+  memcpy (&LAS (hnd).header.number_of_point_records, &header_data[pos], 4); pos += 4;
   for (i = 0 ; i < 5 ; i++)
     {
-      memcpy (&las[hnd].header.number_of_points_by_return[i], &header_data[pos], 4);
+      memcpy (&LAS (hnd).header.number_of_points_by_return[i], &header_data[pos], 4);
       pos += 4;
     }
-  memcpy (&las[hnd].header.x_scale_factor, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.y_scale_factor, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.z_scale_factor, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.x_offset, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.y_offset, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.z_offset, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.max_x, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.min_x, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.max_y, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.min_y, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.max_z, &header_data[pos], 8); pos += 8;
-  memcpy (&las[hnd].header.min_z, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.x_scale_factor, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.y_scale_factor, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.z_scale_factor, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.x_offset, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.y_offset, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.z_offset, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.max_x, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.min_x, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.max_y, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.min_y, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.max_z, &header_data[pos], 8); pos += 8;
+  memcpy (&LAS (hnd).header.min_z, &header_data[pos], 8); pos += 8;
 
 
   /*  Swap the fields in the header that need to be swapped on a big endian system.  */
 
-  if (las[hnd].swap) libslas_swap_las_header (hnd);
+  if (LAS (hnd).swap) libslas_swap_las_header (hnd);
 
 
   /*  Check for v1.3 or greater.  */
 
-  if (las[hnd].header.version_major == 1 && las[hnd].header.version_minor > 2)
+  if (LAS (hnd).header.version_major == 1 && LAS (hnd).header.version_minor > 2)
     {
-      sprintf (libslas_error.info, _("File : %s\nSorry, libslas doesn't support version 1.3 or newer LAS files.\nFunction: %s, Line: %d\n"), las[hnd].path,
+      sprintf (libslas_error.info, _("File : %s\nSorry, libslas doesn't support version 1.3 or newer LAS files.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
                __FUNCTION__, __LINE__ - 3);
       return (libslas_error.libslas = LIBSLAS_INCORRECT_VERSION_ERROR);
     }
 
 
-  las[hnd].write = 0;
-  las[hnd].pos = ftello64 (las[hnd].fp);
+  LAS (hnd).write = 0;
+  LAS (hnd).pos = ftello64 (LAS (hnd).fp);
 
 
 #ifdef LIBSLAS_DEBUG
@@ -447,191 +991,175 @@ static int32_t libslas_read_header (int32_t hnd)
 #endif
 
 
-  return (libslas_error.libslas = LIBSLAS_SUCCESS);
+  return (LIBSLAS_SUCCESS);
 }
 
 
 
+#ifndef NVWIN3X
+
 /********************************************************************************************/
 /*!
 
- - Function:    libslas_create_las_file
+ - Function:    libslas_direct_pread
 
- - Purpose:     Create a LAS file.
+ - Purpose:     Reads point data from a LAS file opened LIBSLAS_READONLY_DIRECT through the
+                O_DIRECT file descriptor.
 
- - Author:      Jan C. Depner (area.based.editor@gmail.com)
+ - Author:      agent (agent@local)
 
- - Date:        07/16/14
+ - Date:        10/16/26
 
  - Arguments:
-                - path           =    Path name
-                - header         =    LIBSLAS_HEADER structure to be written to the file
-
- - Returns:     
-                - The file handle (0 or positive)
-                - LIBSLAS_TOO_MANY_OPEN_FILES_ERROR
-                - LIBSLAS_LAS_CREATE_ERROR
-                - Error value from libslas_write_header
+                - hnd            =    The file handle
+                - addr           =    Address in the file
+                - buffer         =    Buffer to read into
+                - length         =    Number of bytes to read
 
- - Caveats:     All returned error values are less than zero.  Success or a file handle
-                will be greater than or equal to zero.  A simple test for failure is to
-                check to see if the return is less than zero.
+ - Returns:
+                - 0 on success
+                - -1 on failure (or end of file)
+
+ - Caveats:     O_DIRECT reads have to start on a DIRECT_ALIGNMENT boundary in the file, be a
+                multiple of DIRECT_ALIGNMENT bytes long, and go into memory that starts on a
+                DIRECT_ALIGNMENT boundary.  Neither offset_to_point_data nor the record length
+                are going to cooperate so we always read from the aligned address at or before
+                addr.  For big reads we read straight into the caller's buffer starting at its
+                first aligned address, then slide the data down to where it belongs.  That's a
+                memmove but it lets a read of a few megabytes go to the disk as one request.
+                Small reads (and whatever is left at the end) go through an aligned bounce
+                buffer on the stack.
 
-                Please look at the LIBSLAS_HEADER structure in the libslas.h file to determine which
-                fields must be set by your application in the header structure prior to creating
-                the LAS file.
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
 *********************************************************************************************/
 
-int32_t libslas_create_las_file (char *path, LIBSLAS_HEADER *header)
+static int32_t libslas_direct_pread (int32_t hnd, int64_t addr, uint8_t *buffer, size_t length)
 {
-  int32_t i, hnd;
+  uint8_t  bounce[POINT_BLOCK_SIZE + DIRECT_ALIGNMENT], *aligned;
+  int64_t  start;
+  size_t   lead, size, num;
+  ssize_t  got;
 
 
-#ifdef LIBSLAS_DEBUG
-  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d Path = %s\n", __FILE__, __FUNCTION__, __LINE__, path);
-  fflush (LIBSLAS_DEBUG_OUTPUT);
-#endif
+  while (length)
+    {
+      start = addr & ~((int64_t) DIRECT_ALIGNMENT - 1);
+      lead = (size_t) (addr - start);
 
 
-  /*  The first time through we want to initialize all of the LIBSLAS file pointers.  */
+      /*  Figure out how much we can read straight into the caller's buffer.  */
 
-  if (first)
-    {
-      for (i = 0 ; i < LIBSLAS_MAX_FILES ; i++) las[i].fp = NULL;
+      aligned = (uint8_t *) (((size_t) buffer + DIRECT_ALIGNMENT - 1) & ~((size_t) DIRECT_ALIGNMENT - 1));
 
+      size = 0;
+      if (length > (size_t) (aligned - buffer)) size = (length - (size_t) (aligned - buffer)) & ~((size_t) DIRECT_ALIGNMENT - 1);
 
-      /*  Set up the SIGINT handler.  */
 
-      signal (SIGINT, libslas_sigint_handler);
+      /*  Not worth it, use the bounce buffer.  */
 
-      first = 0;
-    }
+      if (size < POINT_BLOCK_SIZE)
+        {
+          aligned = (uint8_t *) (((size_t) bounce + DIRECT_ALIGNMENT - 1) & ~((size_t) DIRECT_ALIGNMENT - 1));
+          size = (lead + MIN (length, POINT_BLOCK_SIZE - lead) + DIRECT_ALIGNMENT - 1) & ~((size_t) DIRECT_ALIGNMENT - 1);
+        }
 
 
-  /*  Find the next available handle and make sure we haven't opened too many.  Also, zero the internal record structure.  */
+      while ((got = pread64 (LAS (hnd).direct_fd, aligned, size, (off64_t) start)) < 0 && errno == EINTR);
 
-  hnd = LIBSLAS_MAX_FILES;
-  for (i = 0 ; i < LIBSLAS_MAX_FILES ; i++)
-    {
-      if (las[i].fp == NULL)
-        {
-          memset (&las[i], 0, sizeof (INTERNAL_LIBSLAS_STRUCT));
+      if (got <= (ssize_t) lead) return (-1);
 
-          hnd = i;
-          break;
-        }
-    }
 
+      num = MIN ((size_t) got - lead, length);
 
-  if (hnd == LIBSLAS_MAX_FILES)
-    {
-      sprintf (libslas_error.info, _("Too many LIBSLAS files are already open.\nFunction: %s, Line: %d\n"),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_TOO_MANY_OPEN_FILES_ERROR);
+      memmove (buffer, aligned + lead, num);
+
+      buffer += num;
+      addr += num;
+      length -= num;
     }
 
 
-  /*  Save the file name for error messages.  */
+  return (0);
+}
 
-  strcpy (las[hnd].path, path);
+#endif
 
 
-  /*  Make sure that the file has a .las extension.  */
 
-  if (strcmp (&path[strlen (path) - 4], ".las"))
-    {
-      sprintf (libslas_error.info, _("File : %s\nInvalid file extension for LAS file (must be .las)\nFunction: %s, Line: %d\n"), las[hnd].path,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_INVALID_FILENAME_ERROR);
-    }
+/********************************************************************************************/
+/*!
 
+ - Function:    libslas_pread
 
-  /*  Set the standard fields.  */
+ - Purpose:     Reads length bytes of point data from the LAS file starting at file position
+                addr without using or changing any shared file position.
 
-  header->version_major = 1;
-  header->version_minor = 2;
-  header->header_size = LIBSLAS_HEADER_SIZE;
-  header->offset_to_point_data = 0;
-  header->number_of_point_records = 0;
-  header->max_x = header->max_y = header->max_z = -99999999999999.0;
-  header->min_x = header->min_y = header->min_z = 99999999999999.0;
+ - Author:      agent (agent@local)
 
-  switch (header->point_data_format_id)
-    {
-    case 0:
-      header->point_data_record_length = 20;
-      break;
+ - Date:        10/16/26
 
-    case 1:
-      header->point_data_record_length = 28;
-      break;
+ - Arguments:
+                - hnd            =    The file handle
+                - addr           =    File position of the first byte to be read
+                - buffer         =    The returned data
+                - length         =    Number of bytes to read
 
-    case 2:
-      header->point_data_record_length = 26;
-      break;
+ - Returns:
+                - 0 on success
+                - -1 on failure (errno will be set if the system set it)
 
-    case 3:
-      header->point_data_record_length = 34;
-      break;
+ - Caveats:     On anything but Windows this is pread on the file descriptor so any number of
+                threads can read through the same handle at the same time.  On Windows we
+                don't have pread so we fall back to fseek and fread, which is not thread safe.
 
-    default:
-      sprintf (libslas_error.info, _("File : %s\nInvalid point format id (%d) specified for LAS file (must be .las)\nFunction: %s, Line: %d\n"), las[hnd].path,
-               header->point_data_format_id, __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_INVALID_POINT_FORMAT_ID_ERROR);
-    }
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
-  for (i = 0 ; i < 5 ; i++) header->number_of_points_by_return[i] = 0;
+*********************************************************************************************/
 
+static int32_t libslas_pread (int32_t hnd, int64_t addr, void *buffer, size_t length)
+{
+#ifdef NVWIN3X
 
-  /*  Check global encoding value.  */
+  /*  We're moving the stdio file position so libslas_append_vlr_record will have to find the end again.  */
 
-  if (header->global_encoding < 0 || header->global_encoding > 1)
-    {
-      sprintf (libslas_error.info, _("File : %s\nInvalid global encoding value (%d) specified for LAS file (must be 0 or 1)\nFunction: %s, Line: %d\n"), las[hnd].path, 
-               header->point_data_format_id, __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_INVALID_GLOBAL_ENCODING_ERROR);
-    }
+  LAS (hnd).at_end = 0;
 
+  if (fseeko64 (LAS (hnd).fp, addr, SEEK_SET) < 0) return (-1);
 
-  /*  Save the entire header to the LIBSLAS internal data structure.  */
+  if (length && !fread (buffer, length, 1, LAS (hnd).fp)) return (-1);
 
-  las[hnd].header = *header;
+#else
 
+  uint8_t  *ptr = (uint8_t *) buffer;
+  ssize_t  num;
 
-  /*  Open the file.  */
 
-  if ((las[hnd].fp = fopen64 (las[hnd].path, "wb+")) == NULL)
-    {
-      sprintf (libslas_error.info, _("File : %s\nError creating LAS file :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_LAS_CREATE_ERROR);
-    }
+  /*  If the file was opened LIBSLAS_READONLY_DIRECT try O_DIRECT first.  If that fails for some reason (like a file system
+      that wants a bigger alignment) we'll just do a normal read.  */
 
+  if (LAS (hnd).direct_fd > 0 && !libslas_direct_pread (hnd, addr, ptr, length)) return (0);
 
-  /*  Write the LAS header.  */
 
-  if (libslas_write_header (hnd) < 0)
+  while (length)
     {
-      fclose (las[hnd].fp);
-      las[hnd].fp = NULL;
-
-      return (libslas_error.libslas);
-    }
+      if ((num = pread64 (LAS (hnd).fd, ptr, length, (off64_t) addr)) <= 0)
+        {
+          if (num < 0 && errno == EINTR) continue;
 
-  las[hnd].at_end = 1;
-  las[hnd].modified = 1;
-  las[hnd].created = 1;
-  las[hnd].write = 1;
+          return (-1);
+        }
 
+      ptr += num;
+      addr += num;
+      length -= num;
+    }
 
-#ifdef LIBSLAS_DEBUG
-  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d\n", __FILE__, __FUNCTION__, __LINE__);
-  fflush (LIBSLAS_DEBUG_OUTPUT);
 #endif
 
-
-  return (hnd);
+  return (0);
 }
 
 
@@ -639,157 +1167,149 @@ int32_t libslas_create_las_file (char *path, LIBSLAS_HEADER *header)
 /********************************************************************************************/
 /*!
 
- - Function:    libslas_open_las_file
+ - Function:    libslas_pwrite
 
- - Purpose:     Open a LAS file.
+ - Purpose:     Writes length bytes of point data to the LAS file starting at file position
+                addr without using or changing any shared file position.
 
- - Author:      Jan C. Depner (area.based.editor@gmail.com)
+ - Author:      agent (agent@local)
 
- - Date:        07/17/14
+ - Date:        10/16/26
 
  - Arguments:
-                - path           =    Path name
-                - header         =    LIBSLAS_HEADER structure to be populated
-                - mode           =    LIBSLAS_UPDATE or LIBSLAS_READONLY
+                - hnd            =    The file handle
+                - addr           =    File position of the first byte to be written
+                - buffer         =    The data to be written
+                - length         =    Number of bytes to write
 
  - Returns:
-                - The file handle (0 or positive)
-                - Error value from libslas_open_las_file
-
-*********************************************************************************************/
-
-int32_t libslas_open_las_file (char *path, LIBSLAS_HEADER *header, int32_t mode)
-{
-  int32_t i, hnd;
+                - 0 on success
+                - -1 on failure (errno will be set)
 
+ - Caveats:     See libslas_pread.
 
-#ifdef LIBSLAS_DEBUG
-  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d Path = %s\n", __FILE__, __FUNCTION__, __LINE__, path);
-  fflush (LIBSLAS_DEBUG_OUTPUT);
-#endif
-
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
-  /*  The first time through we want to initialize all of the LIBSLAS file pointers.  */
+*********************************************************************************************/
 
-  if (first)
-    {
-      for (i = 0 ; i < LIBSLAS_MAX_FILES ; i++) las[i].fp = NULL;
+static int32_t libslas_pwrite (int32_t hnd, int64_t addr, void *buffer, size_t length)
+{
+#ifdef NVWIN3X
 
+  LAS (hnd).at_end = 0;
 
-      /*  Set up the SIGINT handler.  */
+  if (fseeko64 (LAS (hnd).fp, addr, SEEK_SET) < 0) return (-1);
 
-      signal (SIGINT, libslas_sigint_handler);
+  if (length && !fwrite (buffer, length, 1, LAS (hnd).fp)) return (-1);
 
-      first = 0;
-    }
+#else
 
+  uint8_t  *ptr = (uint8_t *) buffer;
+  ssize_t  num;
 
-  /*  Find the next available handle and make sure we haven't opened too many.  Also, zero the internal record structure.  */
 
-  hnd = LIBSLAS_MAX_FILES;
-  for (i = 0 ; i < LIBSLAS_MAX_FILES ; i++)
+  while (length)
     {
-      if (las[i].fp == NULL)
+      if ((num = pwrite64 (LAS (hnd).fd, ptr, length, (off64_t) addr)) < 0)
         {
-          memset (&las[i], 0, sizeof (INTERNAL_LIBSLAS_STRUCT));
+          if (errno == EINTR) continue;
 
-          hnd = i;
-          break;
+          return (-1);
         }
+
+      ptr += num;
+      addr += num;
+      length -= num;
     }
 
+#endif
 
-  if (hnd == LIBSLAS_MAX_FILES)
-    {
-      sprintf (libslas_error.info, _("Too many LIBSLAS files are already open.\nFunction: %s, Line: %d\n"),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_TOO_MANY_OPEN_FILES_ERROR);
-    }
+  return (0);
+}
 
 
-  /*  Save the file name for error messages.  */
 
-  strcpy (las[hnd].path, path);
+#ifndef NO_IO_URING
 
+/********************************************************************************************/
+/*!
 
-  /*  Make sure that the file has a .las extension.  */
+ - Function:    libslas_unmap_io_uring
 
-  if (strcmp (&path[strlen (path) - 4], ".las"))
-    {
-      sprintf (libslas_error.info, _("File : %s\nInvalid file extension for LAS file (must be .las)\nFunction: %s, Line: %d\n"), las[hnd].path,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_INVALID_FILENAME_ERROR);
-    }
+ - Purpose:     Unmaps the rings and closes the io_uring file descriptor.
 
+ - Author:      agent (agent@local)
 
-  if (libslas_big_endian ()) las[hnd].swap = 1;
+ - Date:        10/16/26
 
+ - Arguments:
+                - ring           =    The io_uring state
 
-  /*  Open the file and read the header.  */
+ - Returns:
+                - void
 
-  switch (mode)
-    {
-    case LIBSLAS_UPDATE:
-      if ((las[hnd].fp = fopen64 (path, "rb+")) == NULL)
-        {
-          sprintf (libslas_error.info, _("File : %s\nError opening LAS file for update :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_OPEN_UPDATE_ERROR);
-        }
+ - Caveats:     The mutex is left alone so that libslas_uring_io can shut down a ring that
+                it can't drain while other threads may be waiting for it.  A ring with a zero
+                file descriptor is dead, libslas_uring_io won't use it.
 
-      break;
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
+*********************************************************************************************/
 
-    case LIBSLAS_READONLY:
+static void libslas_unmap_io_uring (URING_STRUCT *ring)
+{
+  if (ring->sqes != NULL && ring->sqes != MAP_FAILED) munmap (ring->sqes, ring->sqes_size);
+  if (ring->cq_map != NULL && ring->cq_map != MAP_FAILED && ring->cq_map != ring->sq_map) munmap (ring->cq_map, ring->cq_map_size);
+  if (ring->sq_map != NULL && ring->sq_map != MAP_FAILED) munmap (ring->sq_map, ring->sq_map_size);
+  if (ring->fd > 0) close (ring->fd);
+
+  ring->sqes = NULL;
+  ring->cq_map = ring->sq_map = NULL;
+  ring->fd = 0;
+}
 
-      if ((las[hnd].fp = fopen64 (path, "rb")) == NULL)
-        {
-          sprintf (libslas_error.info, _("File : %s\nError opening LAS file read-only :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_OPEN_READONLY_ERROR);
-        }
 
-      break;
 
-    default:
-      sprintf (libslas_error.info, _("File : %s\nInvalid file open mode %d specified for file :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, mode, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_INVALID_MODE_ERROR);
-    }
+/********************************************************************************************/
+/*!
 
+ - Function:    libslas_stop_io_uring
 
-  /*  Save the open mode.  */
+ - Purpose:     Tears down the io_uring (if there is one) for a LAS file.
 
-  las[hnd].mode = mode;
+ - Author:      agent (agent@local)
 
+ - Date:        10/16/26
 
-  /*  Read the header.  */
+ - Arguments:
+                - hnd            =    The file handle
 
-  if (libslas_read_header (hnd))
-    {
-      fclose (las[hnd].fp);
-      las[hnd].fp = NULL;
+ - Returns:
+                - void
 
-      return (libslas_error.libslas);
-    }
+ - Caveats:     Also used to clean up after a partially successful libslas_start_io_uring.
 
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
 
-  *header = las[hnd].header;
+static void libslas_stop_io_uring (int32_t hnd)
+{
+  URING_STRUCT  *ring;
 
 
-  las[hnd].at_end = 0;
-  las[hnd].modified = 0;
-  las[hnd].created = 0;
-  las[hnd].write = 0;
+  ring = &LAS_COLD (hnd).uring;
 
+  libslas_unmap_io_uring (ring);
 
-#ifdef LIBSLAS_DEBUG
-  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d\n", __FILE__, __FUNCTION__, __LINE__);
-  fflush (LIBSLAS_DEBUG_OUTPUT);
-#endif
+  if (LAS (hnd).uring != NULL) pthread_mutex_destroy (&ring->mutex);
 
+  memset (ring, 0, sizeof (URING_STRUCT));
 
-  return (hnd);
+  LAS (hnd).uring = NULL;
 }
 
 
@@ -797,563 +1317,434 @@ int32_t libslas_open_las_file (char *path, LIBSLAS_HEADER *header, int32_t mode)
 /********************************************************************************************/
 /*!
 
- - Function:    libslas_close_las_file
+ - Function:    libslas_start_io_uring
 
- - Purpose:     Close a LAS file.
+ - Purpose:     Sets up an io_uring for a LAS file.
 
- - Author:      Jan C. Depner (area.based.editor@gmail.com)
+ - Author:      agent (agent@local)
 
- - Date:        07/16/14
+ - Date:        10/16/26
 
  - Arguments:
                 - hnd            =    The file handle
 
  - Returns:
-                - LIBSLAS_SUCCESS
-                - Error value from libslas_write_header
-                - LIBSLAS_CLOSE_ERROR
+                - 0 on success
+                - -1 if the kernel doesn't support io_uring (or won't let us use it)
 
- - Caveats:     All returned error values are less than zero.  Success or a file handle
-                will be greater than or equal to zero.  A simple test for failure is to
-                check to see if the return is less than zero.
+ - Caveats:     We need IORING_OP_READ and IORING_OP_WRITE which showed up in the 5.6 kernel,
+                the same time as IORING_FEAT_RW_CUR_POS, so we use that to weed out older
+                kernels.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
 *********************************************************************************************/
 
-int32_t libslas_close_las_file (int32_t hnd)
+static int32_t libslas_start_io_uring (int32_t hnd)
 {
-#ifdef LIBSLAS_DEBUG
-  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d Handle = %d\n", __FILE__, __FUNCTION__, __LINE__, hnd);
-  fflush (LIBSLAS_DEBUG_OUTPUT);
-#endif
+  struct io_uring_params  params;
+  URING_STRUCT            *ring;
 
 
-  /*  Just in case someone tries to close a file more than once... */
+  ring = &LAS_COLD (hnd).uring;
 
-  if (las[hnd].fp == NULL) return (libslas_error.libslas = LIBSLAS_SUCCESS);
+  memset (ring, 0, sizeof (URING_STRUCT));
+  memset (&params, 0, sizeof (params));
 
 
-  /*  If the LAS file was created we need to update the header.  */
+  if ((ring->fd = syscall (__NR_io_uring_setup, IO_BATCH_SIZE, &params)) < 0)
+    {
+      ring->fd = 0;
+      return (-1);
+    }
 
-  if (las[hnd].created)
+  if (!(params.features & IORING_FEAT_RW_CUR_POS))
     {
-      if (libslas_write_header (hnd) < 0) return (libslas_error.libslas);
+      libslas_stop_io_uring (hnd);
+      return (-1);
     }
 
 
-  /*  Close the file.  */
+  /*  Map the rings.  Newer kernels let us map both rings with one mmap.  */
 
-  if (fclose (las[hnd].fp))
-    {
-      sprintf (libslas_error.info, _("File : %s\nError closing LAS file :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_CLOSE_ERROR);
-    }
+  ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof (uint32_t);
+  ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof (struct io_uring_cqe);
 
+  if (params.features & IORING_FEAT_SINGLE_MMAP) ring->sq_map_size = ring->cq_map_size = MAX (ring->sq_map_size, ring->cq_map_size);
 
-  /*  Clear the internal LIBSLAS structure.  */
+  ring->sq_map = mmap (NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_SQ_RING);
 
-  memset (&las[hnd], 0, sizeof (INTERNAL_LIBSLAS_STRUCT));
+  if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+      ring->cq_map = ring->sq_map;
+    }
+  else
+    {
+      ring->cq_map = mmap (NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_CQ_RING);
+    }
 
+  ring->sqes_size = params.sq_entries * sizeof (struct io_uring_sqe);
+  ring->sqes = mmap (NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_SQES);
 
-  /*  Set the file pointer to NULL so we can reuse the structure the next create/open.  */
+  if (ring->sq_map == MAP_FAILED || ring->cq_map == MAP_FAILED || ring->sqes == MAP_FAILED)
+    {
+      libslas_stop_io_uring (hnd);
+      return (-1);
+    }
 
-  las[hnd].fp = NULL;
 
+  ring->sq_head = (uint32_t *) (ring->sq_map + params.sq_off.head);
+  ring->sq_tail = (uint32_t *) (ring->sq_map + params.sq_off.tail);
+  ring->sq_mask = (uint32_t *) (ring->sq_map + params.sq_off.ring_mask);
+  ring->sq_array = (uint32_t *) (ring->sq_map + params.sq_off.array);
+  ring->cq_head = (uint32_t *) (ring->cq_map + params.cq_off.head);
+  ring->cq_tail = (uint32_t *) (ring->cq_map + params.cq_off.tail);
+  ring->cq_mask = (uint32_t *) (ring->cq_map + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe *) (ring->cq_map + params.cq_off.cqes);
 
-#ifdef LIBSLAS_DEBUG
-  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d\n", __FILE__, __FUNCTION__, __LINE__);
-  fflush (LIBSLAS_DEBUG_OUTPUT);
-#endif
+  pthread_mutex_init (&ring->mutex, NULL);
 
+  LAS (hnd).uring = ring;
 
-  return (libslas_error.libslas = LIBSLAS_SUCCESS);
+
+  return (0);
 }
 
 
 
-/*********************************************************************************************/
+/********************************************************************************************/
 /*!
 
- - Function:    libslas_read_vlr_header
+ - Function:    libslas_reap_io_uring
 
- - Purpose:     Retrieve a LIBSLAS VLR record.
+ - Purpose:     Takes whatever completions are waiting in an io_uring completion queue.
 
- - Author:      Jan C. Depner (area.based.editor@gmail.com)
+ - Author:      agent (agent@local)
 
- - Date:        07/16/14
+ - Date:        10/16/26
 
  - Arguments:
-                - hnd            =    The file handle
-                - recnum         =    The VLR record number (between 0 and number_of_VLRs from
-                                      the LAS header)
-                - vlr_header     =    The returned LIBSLAS VLR header
+                - ring           =    The io_uring state
+                - count          =    Number of requests in the batch
+                - result         =    Returned number of bytes transferred (or -errno) for each
+                                      request
 
  - Returns:
-                - LIBSLAS_SUCCESS
-                - LIBSLAS_INVALID_VLR_RECORD_NUMBER_ERROR
-                - LIBSLAS_VLR_HEADER_READ_FSEEK_ERROR
-                - LIBSLAS_VLR_HEADER_READ_ERROR
-
- - Caveats:     This function ONLY returns the header.  I'm trying to avoid doing any memory
-                allocation in the API.  Normally you would call this to get the header, allocate
-                your own data buffer, then call libslas_read_vlr_data to get the contents of the
-                VLR.  That way all memory allocation and de-allocation is on the application 
-                side and not hidden away in the API.
+                - Number of completions taken
 
-                All returned error values are less than zero.  Success or a file handle
-                will be greater than or equal to zero.  A simple test for failure is to
-                check to see if the return is less than zero.
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
 *********************************************************************************************/
 
-int32_t libslas_read_vlr_header (int32_t hnd, int32_t recnum, LIBSLAS_VLR_HEADER *vlr_header)
+static int32_t libslas_reap_io_uring (URING_STRUCT *ring, int32_t count, int32_t *result)
 {
-  int32_t i;
-  int64_t pos;
+  int32_t              reaped = 0;
+  uint32_t             head;
+  struct io_uring_cqe  *cqe;
 
 
-  /*  Check for record out of bounds.  */
+  head = *ring->cq_head;
 
-  if (recnum >= las[hnd].header.number_of_VLRs || recnum < 0)
+  while (head != __atomic_load_n (ring->cq_tail, __ATOMIC_ACQUIRE))
     {
-      sprintf (libslas_error.info, _("File : %s\nVLR Record : %d\nInvalid VLR record number.\nFunction: %s, Line: %d\n"), las[hnd].path, recnum,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_INVALID_VLR_RECORD_NUMBER_ERROR);
-    }
+      cqe = &ring->cqes[head & *ring->cq_mask];
 
+      if (cqe->user_data < (uint64_t) count) result[cqe->user_data] = cqe->res;
 
-  pos = (int64_t) las[hnd].header.header_size;
-
-
-  if (fseeko64 (las[hnd].fp, pos, SEEK_SET) < 0)
-    {
-      sprintf (libslas_error.info, _("File : %s\nError during fseek prior to reading VLR header 0 :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_READ_FSEEK_ERROR);
+      head++;
+      reaped++;
     }
 
+  __atomic_store_n (ring->cq_head, head, __ATOMIC_RELEASE);
 
-  for (i = 0 ; i < las[hnd].header.number_of_VLRs ; i++)
-    {
-
-      if (!fread (&vlr_header->reserved, 2, 1, las[hnd].fp))
-        {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (reserved) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
-        }
-
-      if (!fread (&vlr_header->user_id, 16, 1, las[hnd].fp))
-        {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (user id) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
-        }
-
-      if (!fread (&vlr_header->record_id, 2, 1, las[hnd].fp))
-        {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (record id) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
-        }
-
-      if (!fread (&vlr_header->record_length_after_header, 2, 1, las[hnd].fp))
-        {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (record length) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
-        }
-
-      if (!fread (&vlr_header->description, 32, 1, las[hnd].fp))
-        {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (description) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
-        }
-
-
-      /*  Swap things if we need to.  */
-
-      if (las[hnd].swap)
-        {
-          libslas_swap_uint16_t (&vlr_header->record_id);
-          libslas_swap_uint16_t (&vlr_header->record_length_after_header);
-        }
 
+  return (reaped);
+}
 
-      /*  If this is the one we want, return it to the caller.  */
-
-      if (i == recnum) break;
 
 
-      /*  Otherwise, move past the data block and get the next one.  */
+/********************************************************************************************/
+/*!
 
-      pos += vlr_header->record_length_after_header;
+ - Function:    libslas_uring_io
 
+ - Purpose:     Submits a batch of positional reads or writes to the LAS file's io_uring and
+                waits for all of them to complete.
 
-      if (fseeko64 (las[hnd].fp, pos, SEEK_SET) < 0)
-        {
-          sprintf (libslas_error.info, _("File : %s\nError during fseek prior to reading VLR header %d :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, i,
-                   strerror (errno), __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_FSEEK_ERROR);
-        }
-    }
+ - Author:      agent (agent@local)
 
+ - Date:        10/16/26
 
-  las[hnd].write = 0;
-  las[hnd].at_end = 0;
-  las[hnd].pos = ftello64 (las[hnd].fp);
+ - Arguments:
+                - hnd            =    The file handle
+                - req            =    The reads or writes
+                - count          =    Number of requests (no more than IO_BATCH_SIZE)
+                - write          =    1 to write, 0 to read
+                - result         =    Returned number of bytes transferred (or -errno) for each
+                                      request
 
+ - Returns:
+                - 0 on success
+                - -1 if io_uring_enter failed (errno is set)
 
-  return (libslas_error.libslas = LIBSLAS_SUCCESS);
-}
+ - Caveats:     A request that completes with an error or a short transfer is not retried
+                here, the caller has to look at result.
 
+                When io_uring_enter fails we take back the entries the kernel hasn't picked up
+                yet and wait for the ones it has.  We don't return until none of our requests
+                are in flight so the caller can safely redo them with pread/pwrite and the
+                next batch doesn't get our leftovers.  If we can't wait for them, the ring is
+                shut down (see libslas_unmap_io_uring) and never used again.
 
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
-/*********************************************************************************************/
-/*!
+*********************************************************************************************/
 
- - Function:    libslas_read_vlr_data
+static int32_t libslas_uring_io (int32_t hnd, IO_REQUEST *req, int32_t count, uint8_t write, int32_t *result)
+{
+  int32_t              i, submitted, completed, error = 0;
+  uint32_t             tail, idx;
+  struct io_uring_sqe  *sqe;
+  URING_STRUCT         *ring;
 
- - Purpose:     Reads the data for a VLR record.
 
- - Author:      Jan C. Depner (area.based.editor@gmail.com)
+  ring = (URING_STRUCT *) LAS (hnd).uring;
 
- - Date:        07/16/14
 
- - Arguments:
-                - hnd            =    The file handle
-                - recnum         =    The VLR record number (between 0 and number_of_VLRs from
-                                      the LAS header)
-                - vlr_data       =    The returned unsigned character data array.
+  pthread_mutex_lock (&ring->mutex);
 
- - Returns:
-                - LIBSLAS_SUCCESS
-                - LIBSLAS_INVALID_VLR_RECORD_NUMBER_ERROR
-                - LIBSLAS_VLR_DATA_READ_FSEEK_ERROR
-                - LIBSLAS_VLR_DATA_READ_ERROR
 
- - Caveats:     All returned error values are less than zero.  A simple test for failure is to
-                check to see if the return is less than zero.
+  /*  Another thread may have shut the ring down while we were waiting for it.  */
 
-*********************************************************************************************/
+  if (ring->fd <= 0)
+    {
+      pthread_mutex_unlock (&ring->mutex);
+      errno = EIO;
+      return (-1);
+    }
 
-int32_t libslas_read_vlr_data (int32_t hnd, int32_t recnum, uint8_t *vlr_data)
-{
-  int32_t             i;
-  int64_t             pos;
-  LIBSLAS_VLR_HEADER  hdr;
-  uint16_t            tmp_short;
-  double              tmp_double;
 
+  /*  Fill the submission queue.  We're the only one adding to it so we don't need an atomic load of the tail.  */
 
-  /*  Check for record out of bounds.  */
+  tail = *ring->sq_tail;
 
-  if (recnum >= las[hnd].header.number_of_VLRs || recnum < 0)
+  for (i = 0 ; i < count ; i++)
     {
-      sprintf (libslas_error.info, _("File : %s\nVLR Record : %d\nInvalid VLR record number.\nFunction: %s, Line: %d\n"), las[hnd].path, recnum,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_INVALID_VLR_RECORD_NUMBER_ERROR);
-    }
+      idx = (tail + i) & *ring->sq_mask;
 
+      sqe = &ring->sqes[idx];
+      memset (sqe, 0, sizeof (struct io_uring_sqe));
 
-  pos = (int64_t) las[hnd].header.header_size;
+      sqe->opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+      sqe->fd = LAS (hnd).fd;
+      sqe->off = (uint64_t) req[i].addr;
+      sqe->addr = (uint64_t) (size_t) req[i].buffer;
+      sqe->len = (uint32_t) req[i].length;
+      sqe->user_data = (uint64_t) i;
 
-  if (fseeko64 (las[hnd].fp, pos, SEEK_SET) < 0)
-    {
-      sprintf (libslas_error.info, _("File : %s\nError during fseek prior to reading VLR data 0 :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_READ_FSEEK_ERROR);
+      ring->sq_array[idx] = idx;
     }
 
+  __atomic_store_n (ring->sq_tail, tail + count, __ATOMIC_RELEASE);
 
-  for (i = 0 ; i < las[hnd].header.number_of_VLRs ; i++)
-    {
-      if (!fread (&hdr.reserved, 2, 1, las[hnd].fp))
-        {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (reserved) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
-        }
 
-      if (!fread (&hdr.user_id, 16, 1, las[hnd].fp))
-        {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (user id) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
-        }
+  /*  Submit them and reap the completions.  The kernel only takes entries during io_uring_enter (and we hold the mutex)
+      so the submission queue head tells us exactly how many it has.  */
 
-      if (!fread (&hdr.record_id, 2, 1, las[hnd].fp))
-        {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (record id) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
-        }
+  completed = 0;
 
-      if (!fread (&hdr.record_length_after_header, 2, 1, las[hnd].fp))
-        {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (record length) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
-        }
+  while (completed < count)
+    {
+      submitted = (int32_t) (__atomic_load_n (ring->sq_head, __ATOMIC_ACQUIRE) - tail);
 
-      if (!fread (&hdr.description, 32, 1, las[hnd].fp))
+      if (syscall (__NR_io_uring_enter, ring->fd, count - submitted, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
         {
-          sprintf (libslas_error.info, _("File : %s\nError reading VLR header (description) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
+          error = errno;
+          break;
         }
 
+      completed += libslas_reap_io_uring (ring, count, result);
+    }
 
-      /*  Swap things if we need to.  */
 
-      if (las[hnd].swap)
-        {
-          libslas_swap_uint16_t (&hdr.record_id);
-          libslas_swap_uint16_t (&hdr.record_length_after_header);
-        }
+  if (error)
+    {
+      /*  Take back the entries the kernel never saw, then wait for the rest to finish.  */
 
+      submitted = (int32_t) (__atomic_load_n (ring->sq_head, __ATOMIC_ACQUIRE) - tail);
+      __atomic_store_n (ring->sq_tail, tail + submitted, __ATOMIC_RELEASE);
 
-      /*  If this is the one we want, read the data.  */
+      completed += libslas_reap_io_uring (ring, count, result);
 
-      if (i == recnum)
+      while (completed < submitted)
         {
-          /*  First we read the data.  */
-
-          if (!fread (vlr_data, hdr.record_length_after_header, 1, las[hnd].fp))
+          if (syscall (__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
             {
-              sprintf (libslas_error.info, _("File : %s\nError reading VLR data :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-              return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
+              libslas_unmap_io_uring (ring);
+              break;
             }
 
+          completed += libslas_reap_io_uring (ring, count, result);
+        }
 
-          /*  Swap things if we need to.  */
-
-          if (las[hnd].swap)
-            {
-              switch (hdr.record_id)
-                {
-                case 34735:
-                  for (i = 0 ; i < hdr.record_length_after_header ; i += 2)
-                    {
-                      memcpy (&vlr_data[i], &tmp_short, 2);
-                      libslas_swap_uint16_t (&tmp_short);
-                      memcpy (&tmp_short, &vlr_data[i], 2);
-                    }
-                  break;
-
-                case 34736:
-                  for (i = 0 ; i < hdr.record_length_after_header ; i += 8)
-                    {
-                      memcpy (&vlr_data[i], &tmp_double, 8);
-                      libslas_swap_double (&tmp_double);
-                      memcpy (&tmp_double, &vlr_data[i], 8);
-                    }
-                  break;
-                }
-            }
+      pthread_mutex_unlock (&ring->mutex);
+      errno = error;
+      return (-1);
+    }
 
-          break;
-        }
-      else
-        {
-          /*  Otherwise, move past the data block and get the next one.  */
 
-          pos += hdr.record_length_after_header;
+  pthread_mutex_unlock (&ring->mutex);
 
 
-          if (fseeko64 (las[hnd].fp, pos, SEEK_SET) < 0)
-            {
-              sprintf (libslas_error.info, _("File : %s\nError during fseek prior to reading VLR header %d :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, i,
-                       strerror (errno), __FUNCTION__, __LINE__ - 3);
-              return (libslas_error.libslas = LIBSLAS_VLR_READ_FSEEK_ERROR);
-            }
-        }
-    }
+  return (0);
+}
 
+#else
 
-  las[hnd].write = 0;
-  las[hnd].at_end = 0;
-  las[hnd].pos = ftello64 (las[hnd].fp);
+/*  No io_uring.  LAS (hnd).uring is always NULL so these are never actually called.  */
 
+static void libslas_stop_io_uring (int32_t hnd)
+{
+}
 
-  return (libslas_error.libslas = LIBSLAS_SUCCESS);
+static int32_t libslas_uring_io (int32_t hnd, IO_REQUEST *req, int32_t count, uint8_t write, int32_t *result)
+{
+  return (-1);
 }
 
+#endif
+
 
 
 /********************************************************************************************/
 /*!
 
- - Function:    libslas_append_vlr_record
+ - Function:    libslas_batch_io
 
- - Purpose:     Appends a LAS Variable length record to the LAS file (after the header).
+ - Purpose:     Does a batch of positional reads or writes on the point data of a LAS file.
 
- - Author:      Jan C. Depner (area.based.editor@gmail.com)
+ - Author:      agent (agent@local)
 
- - Date:        07/16/14
+ - Date:        10/16/26
 
  - Arguments:
                 - hnd            =    The file handle
-                - vlr_header     =    The LIBSLAS_VLR_HEADER structure (see libslas.h)
-                - vlr_data       =    An unsigned character array containing the data for the VLR.
+                - req            =    The reads or writes
+                - count          =    Number of requests (no more than IO_BATCH_SIZE)
+                - write          =    1 to write, 0 to read
 
  - Returns:
-                - LIBSLAS_SUCCESS
-                - LIBSLAS_VLR_APPEND_ERROR
-                - LIBSLAS_VLR_WRITE_FSEEK_ERROR
-                - LIBSLAS_VLR_WRITE_ERROR
+                - 0 on success
+                - -1 on failure (errno is set)
 
- - Caveats:     This function is ONLY used to append a new vlr record to a file as it is being
-                created.  VLR records must be written prior to and point data records so that
-                the API can keep track of the needed data offset value.
+ - Caveats:     If the file is using the io_uring I/O engine the whole batch is submitted at
+                once.  Anything io_uring didn't finish (a short transfer, an error, or a kernel
+                that doesn't support the operation) is redone with libslas_pread or
+                libslas_pwrite, which is all we do when we're not using io_uring.  That's only
+                safe because libslas_uring_io doesn't return until the kernel is done with
+                all of the requests (or the ring has been shut down).
 
-                All returned error values are less than zero.  Success or a file handle
-                will be greater than or equal to zero.  A simple test for failure is to
-                check to see if the return is less than zero.
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
 *********************************************************************************************/
 
-int32_t libslas_append_vlr_record (int32_t hnd, LIBSLAS_VLR_HEADER *vlr_header, uint8_t *vlr_data)
+static int32_t libslas_batch_io (int32_t hnd, IO_REQUEST *req, int32_t count, uint8_t write)
 {
-  int32_t   i, rec_length;
-  uint16_t  tmp_short;
-  double    tmp_double;
-
+  int32_t  i, result[IO_BATCH_SIZE], uring;
 
-  /*  Appending a VLR is only allowed if you are creating a new file and you haven't written any point records.  */
 
-  if (!las[hnd].created)
-    {
-      sprintf (libslas_error.info, _("File : %s\nAppending VLR records pre-existing LAS file not allowed.\nFunction: %s, Line: %d\n"), las[hnd].path,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_APPEND_ERROR);
-    }
+  uring = (LAS (hnd).uring != NULL && !libslas_uring_io (hnd, req, count, write, result));
 
 
-  if (las[hnd].data)
+  for (i = 0 ; i < count ; i++)
     {
-      sprintf (libslas_error.info, _("File : %s\nVLR records can not be added after writing any point data records.\nFunction: %s, Line: %d\n"), las[hnd].path,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_APPEND_ERROR);
+      if (uring && result[i] == (int32_t) req[i].length) continue;
+
+      if (write)
+        {
+          if (libslas_pwrite (hnd, req[i].addr, req[i].buffer, req[i].length)) return (-1);
+        }
+      else
+        {
+          if (libslas_pread (hnd, req[i].addr, req[i].buffer, req[i].length)) return (-1);
+        }
     }
 
 
-  /*  If we're not already at the end of the file...  */
+  return (0);
+}
 
-  if (!las[hnd].at_end)
-    {
-      /*  We're appending so we need to seek to the end of the file.  */
 
-      if (fseeko64 (las[hnd].fp, 0, SEEK_END) < 0)
-        {
-          sprintf (libslas_error.info, _("File : %s\nError during fseek prior to writing VLR record :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_VLR_WRITE_FSEEK_ERROR);
-        }
-    }
 
+/********************************************************************************************/
+/*!
 
-  las[hnd].at_end = 1;
+ - Function:    libslas_flush_point_buffer
 
+ - Purpose:     Writes the point records staged in the application supplied I/O buffer (see
+                libslas_set_io_buffer) to the LAS file.
 
-  /*  Set reserved field to 0.  */
+ - Author:      agent (agent@local)
 
-  vlr_header->reserved = 0;
+ - Date:        10/16/26
 
+ - Arguments:
+                - hnd            =    The file handle
+                - partial        =    If set, only write up to the last WRITE_ALIGNMENT boundary
+                                      in the file and keep the remainder in the buffer.  If not set,
+                                      write everything.
 
-  rec_length = vlr_header->record_length_after_header;
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_WRITE_ERROR
 
+ - Caveats:     LAS (hnd).pos is the file position of the first byte in the buffer.  We never ask
+                stdio where we are, we just add up what we've written.
 
-  /*  Swap things if we need to.  */
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
-  if (las[hnd].swap)
-    {
-      switch (vlr_header->record_id)
-        {
-        case 34735:
-          for (i = 0 ; i < vlr_header->record_length_after_header ; i += 2)
-            {
-              memcpy (&vlr_data[i], &tmp_short, 2);
-              libslas_swap_uint16_t (&tmp_short);
-              memcpy (&tmp_short, &vlr_data[i], 2);
-            }
-          break;
+*********************************************************************************************/
 
-        case 34736:
-          for (i = 0 ; i < vlr_header->record_length_after_header ; i += 8)
-            {
-              memcpy (&vlr_data[i], &tmp_double, 8);
-              libslas_swap_double (&tmp_double);
-              memcpy (&tmp_double, &vlr_data[i], 8);
-            }
-          break;
-        }
+static int32_t libslas_flush_point_buffer (int32_t hnd, uint8_t partial)
+{
+  int32_t  length;
 
-      libslas_swap_uint16_t (&vlr_header->record_id);
-      libslas_swap_uint16_t (&vlr_header->record_length_after_header);
-    }
 
+  if (!LAS (hnd).buffer_used) return (LIBSLAS_SUCCESS);
 
-  if (!fwrite (&vlr_header->reserved, 2, 1, las[hnd].fp))
-    {
-      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (reserved) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
-    }
 
-  if (!fwrite (&vlr_header->user_id, 16, 1, las[hnd].fp))
-    {
-      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (user id) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
-    }
+  length = LAS (hnd).buffer_used;
 
-  if (!fwrite (&vlr_header->record_id, 2, 1, las[hnd].fp))
-    {
-      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (record id) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
-    }
 
-  if (!fwrite (&vlr_header->record_length_after_header, 2, 1, las[hnd].fp))
-    {
-      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (record length) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
-    }
+  /*  Cut the write off at the last aligned file position if we can.  */
+
+  if (partial && length > (int32_t) ((LAS (hnd).pos + (int64_t) length) % WRITE_ALIGNMENT))
+    length -= (int32_t) ((LAS (hnd).pos + (int64_t) length) % WRITE_ALIGNMENT);
 
-  if (!fwrite (&vlr_header->description, 32, 1, las[hnd].fp))
-    {
-      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (description) :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
-    }
 
-  if (!fwrite (vlr_data, rec_length, 1, las[hnd].fp))
+  if (libslas_pwrite (hnd, LAS (hnd).pos, LAS (hnd).buffer, length))
     {
-      sprintf (libslas_error.info, _("File : %s\nError writing VLR data :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
+      sprintf (libslas_error.info, _("File : %s\nError writing LAS records :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
                __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
+      return (libslas_error.libslas = LIBSLAS_WRITE_ERROR);
     }
 
 
-  /*  Set the offset to the point data to be just after the last VLR written.  */
-
-  las[hnd].pos = las[hnd].header.offset_to_point_data = ftello64 (las[hnd].fp);
+  LAS (hnd).pos += (int64_t) length;
 
-  las[hnd].at_end = 1;
-  las[hnd].write = 1;
 
+  /*  Move whatever is left (less than WRITE_ALIGNMENT bytes) to the beginning of the buffer.  */
 
-#ifdef LIBSLAS_DEBUG
-  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d\n", __FILE__, __FUNCTION__, __LINE__);
-  fflush (LIBSLAS_DEBUG_OUTPUT);
-#endif
+  LAS (hnd).buffer_used -= length;
+  if (LAS (hnd).buffer_used) memmove (LAS (hnd).buffer, &LAS (hnd).buffer[length], LAS (hnd).buffer_used);
 
 
-  return (libslas_error.libslas = LIBSLAS_SUCCESS);
+  return (LIBSLAS_SUCCESS);
 }
 
 
@@ -1361,33 +1752,2364 @@ int32_t libslas_append_vlr_record (int32_t hnd, LIBSLAS_VLR_HEADER *vlr_header,
 /********************************************************************************************/
 /*!
 
- - Function:    libslas_read_point_data
+ - Function:    libslas_write_point_buffer
 
- - Purpose:     Retrieve a LAS point data record.
+ - Purpose:     Writes raw point data to the end of the LAS file.  If the application has
+                supplied an I/O buffer (see libslas_set_io_buffer) the data is staged in the
+                buffer and written in large, aligned chunks.
 
- - Author:      Jan C. Depner (area.based.editor@gmail.com)
+ - Author:      agent (agent@local)
 
- - Date:        07/16/14
+ - Date:        10/16/26
 
  - Arguments:
                 - hnd            =    The file handle
-                - recnum         =    The record number of the LAS point data record to be
-                                      retrieved (records start at 0)
-                - record         =    The returned LAS point data record
+                - data           =    Raw point data
+                - length         =    Number of bytes of raw point data
 
  - Returns:
                 - LIBSLAS_SUCCESS
-                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
-                - LIBSLAS_READ_FSEEK_ERROR
-                - LIBSLAS_READ_ERROR
+                - LIBSLAS_WRITE_ERROR
 
- - Caveats:     All returned error values are less than zero.  Success or a file handle
-                will be greater than or equal to zero.  A simple test for failure is to
-                check to see if the return is less than zero.
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
-                Note that we only have one point data format structure.  Since each of the 
-                point data formats was a subset of POINT DATA RECORD FORMAT 3 it's much easier
-                to just deal with one format.  If you happen to read a POINT DATA RECORD
+*********************************************************************************************/
+
+static int32_t libslas_write_point_buffer (int32_t hnd, uint8_t *data, int32_t length)
+{
+  /*  No buffer or too much data to stage, write it directly.  */
+
+  if (LAS (hnd).buffer == NULL || length > LAS (hnd).buffer_size - WRITE_ALIGNMENT)
+    {
+      if (libslas_flush_point_buffer (hnd, 0)) return (libslas_error.libslas);
+
+      if (libslas_pwrite (hnd, LAS (hnd).pos, data, length))
+        {
+          sprintf (libslas_error.info, _("File : %s\nError writing LAS record :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+                   __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_WRITE_ERROR);
+        }
+
+      LAS (hnd).pos += (int64_t) length;
+
+      return (LIBSLAS_SUCCESS);
+    }
+
+
+  /*  Make room if we need to.  */
+
+  if (LAS (hnd).buffer_used + length > LAS (hnd).buffer_size)
+    {
+      if (libslas_flush_point_buffer (hnd, 1)) return (libslas_error.libslas);
+    }
+
+
+  memcpy (&LAS (hnd).buffer[LAS (hnd).buffer_used], data, length);
+  LAS (hnd).buffer_used += length;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_scan_raw_point_data
+
+ - Purpose:     Accumulates the raw X, Y, and Z integer mins and maxes and the number of points
+                by return for a block of raw point data records.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle (for the record length and swap flag)
+                - data           =    The raw point data records
+                - count          =    Number of records in data
+                - stats          =    The RAW_POINT_STATS structure to be updated.  Zero it
+                                      before the first call.
+
+ - Returns:
+                - -1 if all of the return numbers were valid (1-5)
+                - Otherwise, the index in data of the first record with an invalid return number
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_scan_raw_point_data (int32_t hnd, uint8_t *data, int32_t count, RAW_POINT_STATS *stats)
+{
+  int32_t  i, j, rec_length, xyz[3], ret;
+  uint8_t  *raw;
+
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+
+  for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+    {
+      ret = raw[14] & 0x07;
+
+      if (ret < 1 || ret > 5) return (i);
+
+      stats->number_of_points_by_return[ret - 1]++;
+
+
+      memcpy (xyz, raw, 12);
+
+      for (j = 0 ; j < 3 ; j++)
+        {
+          if (LAS (hnd).swap) libslas_swap_uint32_t ((uint32_t *) &xyz[j]);
+
+          if (!stats->count)
+            {
+              stats->min[j] = stats->max[j] = xyz[j];
+            }
+          else
+            {
+              stats->min[j] = MIN (stats->min[j], xyz[j]);
+              stats->max[j] = MAX (stats->max[j], xyz[j]);
+            }
+        }
+
+      stats->count++;
+    }
+
+
+  return (-1);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_merge_raw_point_stats
+
+ - Purpose:     Adds the statistics gathered by libslas_scan_raw_point_data to the LAS header
+                of a file that is being written.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - stats          =    The RAW_POINT_STATS structure
+
+ - Returns:
+                - void
+
+ - Caveats:     The raw integer mins and maxes are only converted to doubles here, once per
+                block instead of once per record.  We check both ends after scaling in case
+                somebody used a negative scale factor.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_merge_raw_point_stats (int32_t hnd, RAW_POINT_STATS *stats)
+{
+  int32_t  i;
+  double   lo, hi;
+
+
+  if (!stats->count) return;
+
+
+  lo = (double) stats->min[0] * LAS (hnd).header.x_scale_factor + LAS (hnd).header.x_offset;
+  hi = (double) stats->max[0] * LAS (hnd).header.x_scale_factor + LAS (hnd).header.x_offset;
+  LAS (hnd).header.min_x = MIN (LAS (hnd).header.min_x, MIN (lo, hi));
+  LAS (hnd).header.max_x = MAX (LAS (hnd).header.max_x, MAX (lo, hi));
+
+  lo = (double) stats->min[1] * LAS (hnd).header.y_scale_factor + LAS (hnd).header.y_offset;
+  hi = (double) stats->max[1] * LAS (hnd).header.y_scale_factor + LAS (hnd).header.y_offset;
+  LAS (hnd).header.min_y = MIN (LAS (hnd).header.min_y, MIN (lo, hi));
+  LAS (hnd).header.max_y = MAX (LAS (hnd).header.max_y, MAX (lo, hi));
+
+  lo = (double) stats->min[2] * LAS (hnd).header.z_scale_factor + LAS (hnd).header.z_offset;
+  hi = (double) stats->max[2] * LAS (hnd).header.z_scale_factor + LAS (hnd).header.z_offset;
+  LAS (hnd).header.min_z = MIN (LAS (hnd).header.min_z, MIN (lo, hi));
+  LAS (hnd).header.max_z = MAX (LAS (hnd).header.max_z, MAX (lo, hi));
+
+  LAS (hnd).header.number_of_point_records += (uint32_t) stats->count;
+
+  for (i = 0 ; i < 5 ; i++) LAS (hnd).header.number_of_points_by_return[i] += stats->number_of_points_by_return[i];
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_add_raw_point_stats
+
+ - Purpose:     Adds one set of raw point statistics to another.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - total          =    The RAW_POINT_STATS structure being accumulated
+                - stats          =    The RAW_POINT_STATS structure to add to it
+
+ - Returns:
+                - void
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_add_raw_point_stats (RAW_POINT_STATS *total, RAW_POINT_STATS *stats)
+{
+  int32_t  i;
+
+
+  if (!stats->count) return;
+
+
+  for (i = 0 ; i < 3 ; i++)
+    {
+      if (!total->count)
+        {
+          total->min[i] = stats->min[i];
+          total->max[i] = stats->max[i];
+        }
+      else
+        {
+          total->min[i] = MIN (total->min[i], stats->min[i]);
+          total->max[i] = MAX (total->max[i], stats->max[i]);
+        }
+    }
+
+  for (i = 0 ; i < 5 ; i++) total->number_of_points_by_return[i] += stats->number_of_points_by_return[i];
+
+  total->count += stats->count;
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_kernel_copy
+
+ - Purpose:     Copies bytes from one file to another inside the kernel using copy_file_range
+                or, if that isn't available, sendfile.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - in_fd          =    Input file descriptor
+                - in_pos         =    Byte offset in the input file
+                - out_fd         =    Output file descriptor
+                - out_pos        =    Byte offset in the output file
+                - length         =    Number of bytes to copy
+
+ - Returns:
+                - The number of bytes copied.  This will be less than length if the kernel (or
+                  the file system, or the platform) can't do it.  The caller has to copy the
+                  rest the old fashioned way.
+
+ - Caveats:     We call copy_file_range through syscall so that we don't depend on the glibc
+                version.  The output file descriptor's offset is left undefined.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int64_t libslas_kernel_copy (int32_t in_fd, int64_t in_pos, int32_t out_fd, int64_t out_pos, int64_t length)
+{
+  int64_t  done = 0;
+
+#ifdef __linux__
+  int64_t  off_in, off_out;
+  ssize_t  ret;
+
+
+#ifdef __NR_copy_file_range
+  while (done < length)
+    {
+      off_in = in_pos + done;
+      off_out = out_pos + done;
+
+      if ((ret = syscall (__NR_copy_file_range, in_fd, &off_in, out_fd, &off_out, (size_t) MIN (length - done, 0x40000000), 0)) <= 0) break;
+
+      done += ret;
+    }
+#endif
+
+
+  /*  Older kernels (or copying across file systems on them) - try sendfile.  */
+
+  if (done < length && lseek64 (out_fd, out_pos + done, SEEK_SET) >= 0)
+    {
+      while (done < length)
+        {
+          off_in = in_pos + done;
+
+          if ((ret = sendfile64 (out_fd, in_fd, (off64_t *) &off_in, (size_t) MIN (length - done, 0x40000000))) <= 0) break;
+
+          done += ret;
+        }
+    }
+#endif
+
+
+  return (done);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_map_point_data
+
+ - Purpose:     Memory maps the point data block of a LAS file opened with LIBSLAS_READONLY_MMAP.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The LIBSLAS file handle
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_MMAP_ERROR
+
+ - Caveats:     The mapping starts at the page boundary at or below offset_to_point_data and ends
+                at the end of the last point record.  If the file is shorter than the header says
+                it should be we refuse to map it since touching a page past the end of the file
+                would get us a SIGBUS instead of a read error.
+
+                On Windows (NVWIN3X) this does nothing and the file is read through stdio just
+                like a LIBSLAS_READONLY file.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_map_point_data (int32_t hnd)
+{
+#ifndef NVWIN3X
+  static int32_t  min_length[4] = {20, 28, 26, 34};
+  int64_t         start, end, page_size;
+  struct stat64   st;
+
+
+  /*  Nothing to map.  */
+
+  if (!LAS (hnd).header.number_of_point_records) return (LIBSLAS_SUCCESS);
+
+
+  /*  Since we decode straight out of the mapped region we have to make sure a record can't run off the end of it.  */
+
+  if (LAS (hnd).header.point_data_format_id < 4 &&
+      LAS (hnd).header.point_data_record_length < min_length[LAS (hnd).header.point_data_format_id])
+    {
+      sprintf (libslas_error.info, _("File : %s\nPoint data record length %d is too short for point data format %d.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               LAS (hnd).header.point_data_record_length, LAS (hnd).header.point_data_format_id, __FUNCTION__, __LINE__ - 4);
+      return (libslas_error.libslas = LIBSLAS_MMAP_ERROR);
+    }
+
+
+  page_size = (int64_t) sysconf (_SC_PAGESIZE);
+
+  start = ((int64_t) LAS (hnd).header.offset_to_point_data / page_size) * page_size;
+  end = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) LAS (hnd).header.point_data_record_length *
+    (int64_t) LAS (hnd).header.number_of_point_records;
+
+
+  if (fstat64 (fileno (LAS (hnd).fp), &st) < 0 || (int64_t) st.st_size < end)
+    {
+      sprintf (libslas_error.info, _("File : %s\nLAS file is shorter than the point data block described in the header.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_MMAP_ERROR);
+    }
+
+
+  if ((uint64_t) (end - start) > (uint64_t) ((size_t) -1))
+    {
+      sprintf (libslas_error.info, _("File : %s\nPoint data block is too large to map on this system.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_MMAP_ERROR);
+    }
+
+
+  LAS_COLD (hnd).map_size = (size_t) (end - start);
+
+  if ((LAS_COLD (hnd).map = mmap (NULL, LAS_COLD (hnd).map_size, PROT_READ, MAP_SHARED, fileno (LAS (hnd).fp), (off_t) start)) == MAP_FAILED)
+    {
+      LAS_COLD (hnd).map = NULL;
+      LAS_COLD (hnd).map_size = 0;
+
+      sprintf (libslas_error.info, _("File : %s\nError memory mapping LAS point data :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 5);
+      return (libslas_error.libslas = LIBSLAS_MMAP_ERROR);
+    }
+
+  LAS (hnd).points = LAS_COLD (hnd).map + ((int64_t) LAS (hnd).header.offset_to_point_data - start);
+#endif
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+#ifndef NO_READ_AHEAD
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_ahead_thread
+
+ - Purpose:     Read-ahead thread started by libslas_set_read_ahead.  Whenever one of the
+                read-ahead slots is empty it fills it with the next block of point data
+                records.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - arg            =    The file handle (cast to a pointer)
+
+ - Returns:
+                - NULL
+
+ - Caveats:     The header of a read-only file never changes so we can look at it
+                without holding the mutex.  Read errors are not reported here, the slot is
+                just left empty and the application will get the error when it tries to read
+                the records itself.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void *libslas_read_ahead_thread (void *arg)
+{
+  int32_t            hnd, i, slot, rec_length, num_recs;
+  int64_t            addr;
+  uint8_t            ok;
+  READ_AHEAD_STRUCT  *ra;
+
+
+  hnd = (int32_t) (size_t) arg;
+  ra = &LAS_COLD (hnd).read_ahead;
+  rec_length = LAS (hnd).header.point_data_record_length;
+  num_recs = (int32_t) LAS (hnd).header.number_of_point_records;
+
+
+  pthread_mutex_lock (&ra->mutex);
+
+  while (!ra->stop)
+    {
+      /*  Find an empty slot if there's anything left to read.  */
+
+      slot = -1;
+      if (ra->next < num_recs)
+        {
+          for (i = 0 ; i < READ_AHEAD_SLOTS ; i++)
+            {
+              if (ra->state[i] == SLOT_EMPTY)
+                {
+                  slot = i;
+                  break;
+                }
+            }
+        }
+
+
+      /*  Nothing to do, wait for the application to use something up (or move somewhere else).  */
+
+      if (slot < 0)
+        {
+          pthread_cond_wait (&ra->cond, &ra->mutex);
+          continue;
+        }
+
+
+      ra->first[slot] = ra->next;
+      ra->count[slot] = MIN (ra->slot_records, num_recs - ra->next);
+      ra->slot_generation[slot] = ra->generation;
+      ra->state[slot] = SLOT_LOADING;
+      ra->next += ra->count[slot];
+
+      addr = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) rec_length * (int64_t) ra->first[slot];
+
+
+      /*  Don't hold the lock while we're reading.  The application won't touch a slot that's loading.  */
+
+      pthread_mutex_unlock (&ra->mutex);
+
+      ok = !libslas_pread (hnd, addr, ra->slot[slot], (size_t) rec_length * (size_t) ra->count[slot]);
+
+      pthread_mutex_lock (&ra->mutex);
+
+
+      /*  If the application jumped somewhere else while we were reading (or the read failed) throw it away.  */
+
+      ra->state[slot] = (ok && ra->slot_generation[slot] == ra->generation) ? SLOT_FULL : SLOT_EMPTY;
+
+      pthread_cond_broadcast (&ra->cond);
+    }
+
+  pthread_mutex_unlock (&ra->mutex);
+
+
+  return (NULL);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_ahead_record
+
+ - Purpose:     Finds a point data record in the read-ahead slots.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number
+                - count          =    On input, the number of consecutive records the caller
+                                      wants.  On return, the number of consecutive records,
+                                      starting at recnum, that are available at the returned
+                                      address.
+
+ - Returns:
+                - Address of the raw record in the read-ahead buffer
+                - NULL if the record hasn't been (and isn't going to be) read ahead.  In that
+                  case the caller has to read it.
+
+ - Caveats:     If the record is being read by the read-ahead thread we wait for it.  Any slot
+                that holds only records before recnum is given back to the read-ahead thread.
+                If recnum isn't in a slot and isn't the next record the thread is going to
+                read the application has jumped somewhere so we throw away what we have and
+                start reading ahead from just past the records the caller is going to read
+                for itself (unless the application told us it's reading randomly, see
+                libslas_advise).
+
+                The returned address is good until the next read through this handle.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static uint8_t *libslas_read_ahead_record (int32_t hnd, int32_t recnum, int32_t *count)
+{
+  int32_t            i, slot;
+  uint8_t            *raw;
+  READ_AHEAD_STRUCT  *ra;
+
+
+  ra = (READ_AHEAD_STRUCT *) LAS (hnd).ra;
+  raw = NULL;
+
+
+  pthread_mutex_lock (&ra->mutex);
+
+  while (1)
+    {
+      slot = -1;
+      for (i = 0 ; i < READ_AHEAD_SLOTS ; i++)
+        {
+          if (ra->state[i] == SLOT_EMPTY || ra->slot_generation[i] != ra->generation) continue;
+
+
+          /*  We're done with this one.  */
+
+          if (ra->state[i] == SLOT_FULL && ra->first[i] + ra->count[i] <= recnum)
+            {
+              ra->state[i] = SLOT_EMPTY;
+              pthread_cond_broadcast (&ra->cond);
+              continue;
+            }
+
+
+          if (recnum >= ra->first[i] && recnum < ra->first[i] + ra->count[i]) slot = i;
+        }
+
+
+      if (slot >= 0)
+        {
+          /*  Wait for the read-ahead thread to finish reading it.  */
+
+          if (ra->state[slot] == SLOT_LOADING)
+            {
+              pthread_cond_wait (&ra->cond, &ra->mutex);
+              continue;
+            }
+
+          *count = ra->first[slot] + ra->count[slot] - recnum;
+          raw = ra->slot[slot] + (size_t) (recnum - ra->first[slot]) * (size_t) LAS (hnd).header.point_data_record_length;
+          break;
+        }
+
+
+      /*  The read-ahead thread is about to read it.  */
+
+      if (recnum == ra->next)
+        {
+          pthread_cond_wait (&ra->cond, &ra->mutex);
+          continue;
+        }
+
+
+      /*  We jumped.  Throw away what we've got and start over after this record.  */
+
+      for (i = 0 ; i < READ_AHEAD_SLOTS ; i++) if (ra->state[i] == SLOT_FULL) ra->state[i] = SLOT_EMPTY;
+
+      ra->generation++;
+      ra->next = ra->paused ? (int32_t) LAS (hnd).header.number_of_point_records :
+        MIN (recnum + *count, (int32_t) LAS (hnd).header.number_of_point_records);
+
+      pthread_cond_broadcast (&ra->cond);
+      break;
+    }
+
+  pthread_mutex_unlock (&ra->mutex);
+
+
+  return (raw);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_stop_read_ahead
+
+ - Purpose:     Stops the read-ahead thread (if there is one) for a LAS file.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+
+ - Returns:
+                - void
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_stop_read_ahead (int32_t hnd)
+{
+  READ_AHEAD_STRUCT  *ra;
+
+
+  if (LAS (hnd).ra == NULL) return;
+
+  ra = (READ_AHEAD_STRUCT *) LAS (hnd).ra;
+
+
+  pthread_mutex_lock (&ra->mutex);
+  ra->stop = 1;
+  pthread_cond_broadcast (&ra->cond);
+  pthread_mutex_unlock (&ra->mutex);
+
+  pthread_join (ra->thread, NULL);
+
+  pthread_cond_destroy (&ra->cond);
+  pthread_mutex_destroy (&ra->mutex);
+
+
+  LAS (hnd).ra = NULL;
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_restart_read_ahead
+
+ - Purpose:     Throws away whatever has been read ahead and starts reading ahead again at
+                the specified record.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    Record number at which to start reading ahead
+                - paused         =    If set, don't read ahead at all until the next restart
+                                      that isn't paused
+
+ - Returns:
+                - void
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_restart_read_ahead (int32_t hnd, int32_t recnum, uint8_t paused)
+{
+  int32_t            i;
+  READ_AHEAD_STRUCT  *ra;
+
+
+  ra = (READ_AHEAD_STRUCT *) LAS (hnd).ra;
+
+
+  pthread_mutex_lock (&ra->mutex);
+
+  for (i = 0 ; i < READ_AHEAD_SLOTS ; i++) if (ra->state[i] == SLOT_FULL) ra->state[i] = SLOT_EMPTY;
+
+  ra->generation++;
+  ra->paused = paused;
+  ra->next = paused ? (int32_t) LAS (hnd).header.number_of_point_records : recnum;
+
+  pthread_cond_broadcast (&ra->cond);
+
+  pthread_mutex_unlock (&ra->mutex);
+}
+
+#else
+
+/*  No read-ahead on Windows.  LAS (hnd).ra is always NULL so these are never actually called.  */
+
+static uint8_t *libslas_read_ahead_record (int32_t hnd, int32_t recnum, int32_t *count)
+{
+  return (NULL);
+}
+
+static void libslas_stop_read_ahead (int32_t hnd)
+{
+}
+
+static void libslas_restart_read_ahead (int32_t hnd, int32_t recnum, uint8_t paused)
+{
+}
+
+#endif
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_unpack_vlr_header
+
+ - Purpose:     Unpacks a VLR header as it is stored in the file.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - data           =    VLR_HEADER_SIZE bytes of raw VLR header
+                - vlr_header     =    The returned LIBSLAS VLR header
+
+ - Returns:
+                - void
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_unpack_vlr_header (int32_t hnd, uint8_t *data, LIBSLAS_VLR_HEADER *vlr_header)
+{
+  memcpy (&vlr_header->reserved, &data[0], 2);
+  memcpy (vlr_header->user_id, &data[2], 16);
+  vlr_header->user_id[16] = 0;
+  memcpy (&vlr_header->record_id, &data[18], 2);
+  memcpy (&vlr_header->record_length_after_header, &data[20], 2);
+  memcpy (vlr_header->description, &data[22], 32);
+  vlr_header->description[32] = 0;
+
+
+  /*  Swap things if we need to.  */
+
+  if (LAS (hnd).swap)
+    {
+      libslas_swap_uint16_t (&vlr_header->record_id);
+      libslas_swap_uint16_t (&vlr_header->record_length_after_header);
+    }
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_vlr_directory
+
+ - Purpose:     Reads the VLR headers of a LAS file that is being opened into the VLR
+                directory.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+
+ - Caveats:     The directory has room for all of the VLRs in the header.  We make one pass
+                through the VLR headers, a POINT_BLOCK_SIZE block at a time, and the VLRs
+                almost always fit in one block.  We don't report read errors here.  If the
+                VLRs are damaged the directory just stops short and libslas_find_vlr_header
+                will report the error if the application ever tries to read them.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_read_vlr_directory (int32_t hnd)
+{
+  int32_t  i, count;
+  int64_t  addr, start = 0, end;
+  size_t   length = 0;
+  uint8_t  block[POINT_BLOCK_SIZE];
+
+
+  count = (int32_t) LAS (hnd).header.number_of_VLRs;
+
+  if (count <= 0) return (LIBSLAS_SUCCESS);
+
+  if ((LAS_COLD (hnd).vlr = (VLR_ENTRY *) malloc ((size_t) count * sizeof (VLR_ENTRY))) == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nUnable to allocate memory for the VLR directory :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_MEMORY_ALLOCATION_ERROR);
+    }
+
+  addr = (int64_t) LAS (hnd).header.header_size;
+  end = (int64_t) LAS (hnd).header.offset_to_point_data;
+
+  for (i = 0 ; i < count ; i++)
+    {
+      /*  Read another block if this header isn't in the one we have.  */
+
+      if (addr < start || addr + VLR_HEADER_SIZE > start + (int64_t) length)
+        {
+          start = addr;
+          length = (size_t) MIN ((int64_t) POINT_BLOCK_SIZE, MAX (end - addr, (int64_t) VLR_HEADER_SIZE));
+
+          if (libslas_pread (hnd, start, block, length)) break;
+        }
+
+      libslas_unpack_vlr_header (hnd, &block[addr - start], &LAS_COLD (hnd).vlr[i].header);
+      LAS_COLD (hnd).vlr[i].addr = addr;
+
+      addr += VLR_HEADER_SIZE + (int64_t) LAS_COLD (hnd).vlr[i].header.record_length_after_header;
+    }
+
+  LAS_COLD (hnd).vlr_count = i;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_find_vlr_header
+
+ - Purpose:     Finds a VLR header and its location in the file.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The VLR record number
+                - vlr_header     =    The returned LIBSLAS VLR header
+                - addr           =    The returned address of the VLR header in the file
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_VLR_READ_ERROR
+
+ - Caveats:     Every VLR is in the directory (see libslas_read_vlr_directory and
+                libslas_append_vlr_record) so this doesn't do any I/O.  If it isn't there the
+                VLRs are damaged (or, if we're creating the file, it hasn't been written yet).
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_find_vlr_header (int32_t hnd, int32_t recnum, LIBSLAS_VLR_HEADER *vlr_header, int64_t *addr)
+{
+  if (recnum >= LAS_COLD (hnd).vlr_count)
+    {
+      sprintf (libslas_error.info, _("File : %s\nVLR header %d is damaged or hasn't been written.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
+    }
+
+  *vlr_header = LAS_COLD (hnd).vlr[recnum].header;
+  *addr = LAS_COLD (hnd).vlr[recnum].addr;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_start_append
+
+ - Purpose:     Sets up a LAS file that was opened LIBSLAS_APPEND so that point data records
+                can be appended to it.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_APPEND_ERROR
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_start_append (int32_t hnd)
+{
+  static uint16_t standard_length[4] = {20, 28, 26, 34};
+
+
+  /*  We only know how to pack the standard fields.  */
+
+  if (LAS (hnd).header.point_data_format_id > 3 ||
+      LAS (hnd).header.point_data_record_length != standard_length[LAS (hnd).header.point_data_format_id])
+    {
+      sprintf (libslas_error.info, _("File : %s\nCan't append to a LAS file with non-standard point data records (format %d, length %d).\nFunction: %s, Line: %d\n"),
+               LAS_COLD (hnd).path, LAS (hnd).header.point_data_format_id, LAS (hnd).header.point_data_record_length, __FUNCTION__, __LINE__ - 4);
+      return (libslas_error.libslas = LIBSLAS_APPEND_ERROR);
+    }
+
+
+  /*  An empty file doesn't have any bounds yet.  */
+
+  if (!LAS (hnd).header.number_of_point_records)
+    {
+      LAS (hnd).header.max_x = LAS (hnd).header.max_y = LAS (hnd).header.max_z = -99999999999999.0;
+      LAS (hnd).header.min_x = LAS (hnd).header.min_y = LAS (hnd).header.min_z = 99999999999999.0;
+    }
+
+
+  /*  New records go right after the last one.  Setting data keeps anyone from adding VLRs.  */
+
+  LAS (hnd).pos = (int64_t) LAS (hnd).header.offset_to_point_data +
+    (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) LAS (hnd).header.number_of_point_records;
+
+  LAS (hnd).append = 1;
+  LAS (hnd).data = 1;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_free_time_index
+
+ - Purpose:     Frees the cached GPS time index of a LAS file.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+
+ - Returns:
+                - void
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_free_time_index (int32_t hnd)
+{
+  free (LAS_COLD (hnd).time_index);
+
+  LAS_COLD (hnd).time_index = NULL;
+  LAS_COLD (hnd).time_count = 0;
+  LAS_COLD (hnd).time_sorted = 0;
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_create_las_file
+
+ - Purpose:     Create a LAS file.
+
+ - Author:      Jan C. Depner (area.based.editor@gmail.com)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - path           =    Path name
+                - header         =    LIBSLAS_HEADER structure to be written to the file
+
+ - Returns:     
+                - The file handle (0 or positive)
+                - LIBSLAS_TOO_MANY_OPEN_FILES_ERROR
+                - LIBSLAS_LAS_CREATE_ERROR
+                - Error value from libslas_write_header
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                Please look at the LIBSLAS_HEADER structure in the libslas.h file to determine which
+                fields must be set by your application in the header structure prior to creating
+                the LAS file.
+
+*********************************************************************************************/
+
+int32_t libslas_create_las_file (char *path, LIBSLAS_HEADER *header)
+{
+  int32_t i, hnd;
+
+
+#ifdef LIBSLAS_DEBUG
+  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d Path = %s\n", __FILE__, __FUNCTION__, __LINE__, path);
+  fflush (LIBSLAS_DEBUG_OUTPUT);
+#endif
+
+
+  /*  Get a free handle (this also zeroes the internal record structures).  */
+
+  if ((hnd = libslas_get_handle ()) < 0) return (hnd);
+
+
+  /*  Save the file name for error messages.  */
+
+  strcpy (LAS_COLD (hnd).path, path);
+
+
+  /*  Make sure that the file has a .las extension.  */
+
+  if (strcmp (&path[strlen (path) - 4], ".las"))
+    {
+      sprintf (libslas_error.info, _("File : %s\nInvalid file extension for LAS file (must be .las)\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      libslas_release_handle (hnd);
+      return (libslas_error.libslas = LIBSLAS_INVALID_FILENAME_ERROR);
+    }
+
+
+  /*  Set the standard fields.  */
+
+  header->version_major = 1;
+  header->version_minor = 2;
+  header->header_size = LIBSLAS_HEADER_SIZE;
+  header->offset_to_point_data = 0;
+  header->number_of_point_records = 0;
+  header->max_x = header->max_y = header->max_z = -99999999999999.0;
+  header->min_x = header->min_y = header->min_z = 99999999999999.0;
+
+  switch (header->point_data_format_id)
+    {
+    case 0:
+      header->point_data_record_length = 20;
+      break;
+
+    case 1:
+      header->point_data_record_length = 28;
+      break;
+
+    case 2:
+      header->point_data_record_length = 26;
+      break;
+
+    case 3:
+      header->point_data_record_length = 34;
+      break;
+
+    default:
+      sprintf (libslas_error.info, _("File : %s\nInvalid point format id (%d) specified for LAS file (must be .las)\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               header->point_data_format_id, __FUNCTION__, __LINE__ - 3);
+      libslas_release_handle (hnd);
+      return (libslas_error.libslas = LIBSLAS_INVALID_POINT_FORMAT_ID_ERROR);
+    }
+
+  for (i = 0 ; i < 5 ; i++) header->number_of_points_by_return[i] = 0;
+
+
+  /*  Check global encoding value.  */
+
+  if (header->global_encoding < 0 || header->global_encoding > 1)
+    {
+      sprintf (libslas_error.info, _("File : %s\nInvalid global encoding value (%d) specified for LAS file (must be 0 or 1)\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, 
+               header->point_data_format_id, __FUNCTION__, __LINE__ - 3);
+      libslas_release_handle (hnd);
+      return (libslas_error.libslas = LIBSLAS_INVALID_GLOBAL_ENCODING_ERROR);
+    }
+
+
+  /*  Save the entire header to the LIBSLAS internal data structure.  */
+
+  LAS (hnd).header = *header;
+
+
+  /*  Open the file.  */
+
+  if ((LAS (hnd).fp = fopen64 (LAS_COLD (hnd).path, "wb+")) == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nError creating LAS file :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      libslas_release_handle (hnd);
+      return (libslas_error.libslas = LIBSLAS_LAS_CREATE_ERROR);
+    }
+
+  LAS (hnd).fd = fileno (LAS (hnd).fp);
+
+
+  /*  Write the LAS header.  */
+
+  if (libslas_write_header (hnd) < 0)
+    {
+      fclose (LAS (hnd).fp);
+      libslas_release_handle (hnd);
+
+      return (libslas_error.libslas);
+    }
+
+  LAS (hnd).at_end = 1;
+  LAS (hnd).modified = 1;
+  LAS (hnd).created = 1;
+  LAS (hnd).write = 1;
+
+
+#ifdef LIBSLAS_DEBUG
+  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d\n", __FILE__, __FUNCTION__, __LINE__);
+  fflush (LIBSLAS_DEBUG_OUTPUT);
+#endif
+
+
+  return (hnd);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_create_las_file_hint
+
+ - Purpose:     Create a LAS file that is expected to hold a known (approximate) number of
+                point data records and preallocate the disk space for it.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - path           =    Path name
+                - header         =    LIBSLAS_HEADER structure to be written to the file
+                - expected_points =   Expected number of point data records
+
+ - Returns:
+                - The file handle (0 or positive)
+                - Error value from libslas_create_las_file
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                This is exactly the same as libslas_create_las_file except that, on Linux, the
+                file is fallocated to hold the header, the point data, and POINT_BLOCK_SIZE
+                bytes of VLRs.  When a lot of files are being written at the same time (e.g.
+                tiling) growing each one a little at a time scatters them all over the disk.
+                Preallocating keeps each file contiguous so reading it later is a sequential
+                read.  The blocks are reserved with FALLOC_FL_KEEP_SIZE so the file size
+                doesn't change until the points are actually written (a reader, or a writer
+                that crashes, never sees a zero filled tail).  Any reserved space that wasn't
+                used is given back when the file is closed.  If you write more points than you
+                said you would the file just grows like normal.
+
+                The expected point count is only a hint.  If the file system can't
+                preallocate the file (or this isn't Linux) it is ignored.
+
+*********************************************************************************************/
+
+int32_t libslas_create_las_file_hint (char *path, LIBSLAS_HEADER *header, int32_t expected_points)
+{
+  int32_t hnd;
+#ifdef __linux__
+  int64_t size;
+#endif
+
+
+  if ((hnd = libslas_create_las_file (path, header)) < 0) return (hnd);
+
+
+#ifdef __linux__
+  if (expected_points > 0)
+    {
+      size = (int64_t) LAS (hnd).header.header_size + (int64_t) POINT_BLOCK_SIZE +
+        (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) expected_points;
+
+      if (!fallocate64 (LAS (hnd).fd, FALLOC_FL_KEEP_SIZE, 0, size)) LAS_COLD (hnd).prealloc = size;
+    }
+#endif
+
+
+  return (hnd);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_open_las_file
+
+ - Purpose:     Open a LAS file.
+
+ - Author:      Jan C. Depner (area.based.editor@gmail.com)
+
+ - Date:        07/17/14
+
+ - Arguments:
+                - path           =    Path name
+                - header         =    LIBSLAS_HEADER structure to be populated
+                - mode           =    LIBSLAS_UPDATE, LIBSLAS_READONLY, LIBSLAS_READONLY_MMAP,
+                                      LIBSLAS_READONLY_DIRECT, or LIBSLAS_APPEND
+
+ - Returns:
+                - The file handle (0 or positive)
+                - Error value from libslas_open_las_file
+
+ - Caveats:     LIBSLAS_READONLY_MMAP opens the file read-only and memory maps the point data
+                block.  Point reads are then decoded straight out of the page cache with no
+                seeks, copies, or system calls.  On Windows this mode is the same as
+                LIBSLAS_READONLY.
+
+                LIBSLAS_READONLY_DIRECT opens the file read-only and reads the point data with
+                O_DIRECT so a one pass scan of a huge file doesn't push everything else out of
+                the page cache.  The header is still read through stdio.  O_DIRECT
+                reads bypass the kernel's read-ahead so use libslas_set_read_ahead with a buffer
+                of a few megabytes per slot if you want to keep the disk busy.  If the system
+                or file system doesn't do O_DIRECT (Windows, Mac OS/X, tmpfs, ...) this mode
+                is the same as LIBSLAS_READONLY.
+
+                LIBSLAS_APPEND opens an existing file so that you can add point data records to
+                the end of it with libslas_append_point_data, libslas_append_raw_point_data, or
+                libslas_copy_point_data just like a file you are creating.  Nothing that is
+                already in the file is read so the cost only depends on how much you add.  The
+                number of points, number of points by return, and the bounds in the header are
+                updated as you go and the header is rewritten when you close the file.  You can't
+                add VLRs or modify existing records in this mode and, since we only know how to
+                pack the standard fields, the point records can't have any extra bytes.  If the
+                application is killed (SIGINT) while appending the file is not removed.  The
+                header will still have the old point count so the file will look like it did
+                before you opened it.
+
+*********************************************************************************************/
+
+int32_t libslas_open_las_file (char *path, LIBSLAS_HEADER *header, int32_t mode)
+{
+  int32_t hnd;
+
+
+#ifdef LIBSLAS_DEBUG
+  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d Path = %s\n", __FILE__, __FUNCTION__, __LINE__, path);
+  fflush (LIBSLAS_DEBUG_OUTPUT);
+#endif
+
+
+  /*  Get a free handle (this also zeroes the internal record structures).  */
+
+  if ((hnd = libslas_get_handle ()) < 0) return (hnd);
+
+
+  /*  Save the file name for error messages.  */
+
+  strcpy (LAS_COLD (hnd).path, path);
+
+
+  /*  Make sure that the file has a .las extension.  */
+
+  if (strcmp (&path[strlen (path) - 4], ".las"))
+    {
+      sprintf (libslas_error.info, _("File : %s\nInvalid file extension for LAS file (must be .las)\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      libslas_release_handle (hnd);
+      return (libslas_error.libslas = LIBSLAS_INVALID_FILENAME_ERROR);
+    }
+
+
+  if (libslas_big_endian ()) LAS (hnd).swap = 1;
+
+
+  /*  Open the file and read the header.  */
+
+  switch (mode)
+    {
+    case LIBSLAS_UPDATE:
+    case LIBSLAS_APPEND:
+      if ((LAS (hnd).fp = fopen64 (path, "rb+")) == NULL)
+        {
+          sprintf (libslas_error.info, _("File : %s\nError opening LAS file for update :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+          libslas_release_handle (hnd);
+          return (libslas_error.libslas = LIBSLAS_OPEN_UPDATE_ERROR);
+        }
+
+      break;
+
+
+    case LIBSLAS_READONLY:
+    case LIBSLAS_READONLY_MMAP:
+    case LIBSLAS_READONLY_DIRECT:
+
+      if ((LAS (hnd).fp = fopen64 (path, "rb")) == NULL)
+        {
+          sprintf (libslas_error.info, _("File : %s\nError opening LAS file read-only :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+          libslas_release_handle (hnd);
+          return (libslas_error.libslas = LIBSLAS_OPEN_READONLY_ERROR);
+        }
+
+      break;
+
+    default:
+      sprintf (libslas_error.info, _("File : %s\nInvalid file open mode %d specified for file :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, mode, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      libslas_release_handle (hnd);
+      return (libslas_error.libslas = LIBSLAS_INVALID_MODE_ERROR);
+    }
+
+
+  /*  Save the open mode and the file descriptor.  */
+
+  LAS (hnd).mode = mode;
+  LAS (hnd).fd = fileno (LAS (hnd).fp);
+
+
+  /*  Read the header.  */
+
+  if (libslas_read_header (hnd))
+    {
+      fclose (LAS (hnd).fp);
+      libslas_release_handle (hnd);
+
+      return (libslas_error.libslas);
+    }
+
+
+  /*  Read the VLR headers so we don't have to go looking for them later.  */
+
+  if (libslas_read_vlr_directory (hnd))
+    {
+      fclose (LAS (hnd).fp);
+      libslas_release_handle (hnd);
+      return (libslas_error.libslas);
+    }
+
+
+  /*  If we're appending, get set up to write after the last point record.  */
+
+  if (mode == LIBSLAS_APPEND && libslas_start_append (hnd))
+    {
+      fclose (LAS (hnd).fp);
+      libslas_release_handle (hnd);
+
+      return (libslas_error.libslas);
+    }
+
+
+  /*  Map the point data if requested.  */
+
+  if (mode == LIBSLAS_READONLY_MMAP && libslas_map_point_data (hnd))
+    {
+      fclose (LAS (hnd).fp);
+      libslas_release_handle (hnd);
+
+      return (libslas_error.libslas);
+    }
+
+
+  /*  Open the file again with O_DIRECT for point data reads if requested.  If we can't we just read through fd.  */
+
+#if !(defined NVWIN3X) && (defined O_DIRECT)
+  if (mode == LIBSLAS_READONLY_DIRECT && (LAS (hnd).direct_fd = open64 (path, O_RDONLY | O_DIRECT)) < 0) LAS (hnd).direct_fd = 0;
+#endif
+
+
+  *header = LAS (hnd).header;
+
+
+  LAS (hnd).at_end = 0;
+  LAS (hnd).modified = 0;
+  LAS (hnd).created = 0;
+  LAS (hnd).write = 0;
+
+
+#ifdef LIBSLAS_DEBUG
+  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d\n", __FILE__, __FUNCTION__, __LINE__);
+  fflush (LIBSLAS_DEBUG_OUTPUT);
+#endif
+
+
+  return (hnd);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_close_las_file
+
+ - Purpose:     Close a LAS file.
+
+ - Author:      Jan C. Depner (area.based.editor@gmail.com)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - hnd            =    The file handle
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - Error value from libslas_write_header
+                - LIBSLAS_CLOSE_ERROR
+                - LIBSLAS_POINT_COUNT_ERROR (the file was created with a declared point
+                  count that doesn't match the number of point records written).  The file
+                  is still closed and the handle is still released in this case.
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+*********************************************************************************************/
+
+int32_t libslas_close_las_file (int32_t hnd)
+{
+  uint8_t valid, short_count = 0;
+  int64_t end = 0;
+
+
+#ifdef LIBSLAS_DEBUG
+  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d Handle = %d\n", __FILE__, __FUNCTION__, __LINE__, hnd);
+  fflush (LIBSLAS_DEBUG_OUTPUT);
+#endif
+
+
+  /*  Just in case someone tries to close a file more than once (or close a handle that was never opened)... */
+
+  LIBSLAS_LOCK ();
+  valid = (hnd >= 0 && hnd < las_chunks * LIBSLAS_CHUNK_SIZE);
+  LIBSLAS_UNLOCK ();
+
+  if (!valid || LAS (hnd).fp == NULL) return (LIBSLAS_SUCCESS);
+
+
+  /*  If the LAS file was created (or appended to) we need to write any buffered point data and update the header.  */
+
+  if (LAS (hnd).created || LAS (hnd).append)
+    {
+      if (libslas_flush_point_buffer (hnd, 0)) return (libslas_error.libslas);
+
+
+      /*  If the records were written with libslas_write_point_data, add up what all of the threads wrote.  The file has
+          the declared number of records in it whether they were all written or not.  */
+
+      if (LAS (hnd).parallel)
+        {
+          LIBSLAS_STATS_LOCK (hnd);
+          libslas_merge_raw_point_stats (hnd, &LAS_COLD (hnd).stats);
+          short_count = (LAS_COLD (hnd).stats.count != LAS (hnd).declared);
+          memset (&LAS_COLD (hnd).stats, 0, sizeof (RAW_POINT_STATS));
+          LIBSLAS_STATS_UNLOCK (hnd);
+
+          LAS (hnd).header.number_of_point_records = LAS (hnd).declared;
+        }
+
+
+      /*  Remember where the data ends (libslas_write_header moves LAS (hnd).pos).  */
+
+      end = LAS (hnd).pos;
+      if (LAS (hnd).parallel)
+        end = MAX (end, (int64_t) LAS (hnd).header.offset_to_point_data +
+                   (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) LAS (hnd).declared);
+
+
+      if (libslas_write_header (hnd) < 0) return (libslas_error.libslas);
+
+
+      /*  If we preallocated the file, give back the reserved blocks we didn't use.  The size is normally already end (we
+          used FALLOC_FL_KEEP_SIZE) but truncating frees the blocks past it.  */
+
+#ifdef __linux__
+      if (LAS_COLD (hnd).prealloc && end < LAS_COLD (hnd).prealloc)
+        {
+          if (fflush (LAS (hnd).fp) || ftruncate64 (LAS (hnd).fd, end))
+            {
+              sprintf (libslas_error.info, _("File : %s\nError truncating preallocated LAS file :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+                       strerror (errno), __FUNCTION__, __LINE__ - 3);
+              return (libslas_error.libslas = LIBSLAS_CLOSE_ERROR);
+            }
+        }
+#endif
+    }
+
+
+  /*  Stop the read-ahead thread if there is one.  */
+
+  libslas_stop_read_ahead (hnd);
+
+
+  /*  Tear down the io_uring if there is one.  */
+
+  if (LAS (hnd).uring != NULL) libslas_stop_io_uring (hnd);
+
+
+  /*  Unmap the point data if we mapped it.  */
+
+#ifndef NVWIN3X
+  if (LAS_COLD (hnd).map != NULL) munmap (LAS_COLD (hnd).map, LAS_COLD (hnd).map_size);
+#endif
+
+
+  /*  Close the file.  */
+
+#ifndef NVWIN3X
+  if (LAS (hnd).direct_fd > 0) close (LAS (hnd).direct_fd);
+#endif
+
+  if (fclose (LAS (hnd).fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError closing LAS file :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_CLOSE_ERROR);
+    }
+
+
+  if (short_count)
+    sprintf (libslas_error.info, _("File : %s\nThe number of point records written does not match the declared point count.\nFunction: %s, Line: %d\n"),
+             LAS_COLD (hnd).path, __FUNCTION__, __LINE__ - 2);
+
+  if (LAS (hnd).parallel) LIBSLAS_STATS_DESTROY (hnd);
+
+
+  libslas_free_time_index (hnd);
+
+
+  /*  Clear the internal LIBSLAS structures (this also sets the file pointer to NULL) and put the handle back in the free
+      list so we can reuse it the next create/open.  */
+
+  libslas_release_handle (hnd);
+
+
+  if (short_count) return (libslas_error.libslas = LIBSLAS_POINT_COUNT_ERROR);
+
+
+#ifdef LIBSLAS_DEBUG
+  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d\n", __FILE__, __FUNCTION__, __LINE__);
+  fflush (LIBSLAS_DEBUG_OUTPUT);
+#endif
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/*********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_vlr_header
+
+ - Purpose:     Retrieve a LIBSLAS VLR record.
+
+ - Author:      Jan C. Depner (area.based.editor@gmail.com)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The VLR record number (between 0 and number_of_VLRs from
+                                      the LAS header)
+                - vlr_header     =    The returned LIBSLAS VLR header
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_VLR_RECORD_NUMBER_ERROR
+                - LIBSLAS_VLR_READ_ERROR
+
+ - Caveats:     This function ONLY returns the header.  I'm trying to avoid doing any memory
+                allocation in the API.  Normally you would call this to get the header, allocate
+                your own data buffer, then call libslas_read_vlr_data to get the contents of the
+                VLR.  That way all memory allocation and de-allocation is on the application 
+                side and not hidden away in the API.
+
+                All of the VLR headers are read when the file is opened so this doesn't do any
+                I/O.  Use libslas_find_vlr if you're looking for a particular VLR.
+
+                All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+*********************************************************************************************/
+
+int32_t libslas_read_vlr_header (int32_t hnd, int32_t recnum, LIBSLAS_VLR_HEADER *vlr_header)
+{
+  int64_t addr;
+
+
+  /*  Check for record out of bounds.  */
+
+  if (recnum >= LAS (hnd).header.number_of_VLRs || recnum < 0)
+    {
+      sprintf (libslas_error.info, _("File : %s\nVLR Record : %d\nInvalid VLR record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_VLR_RECORD_NUMBER_ERROR);
+    }
+
+
+  return (libslas_find_vlr_header (hnd, recnum, vlr_header, &addr));
+}
+
+
+
+/*********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_vlr_data
+
+ - Purpose:     Reads the data for a VLR record.
+
+ - Author:      Jan C. Depner (area.based.editor@gmail.com)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The VLR record number (between 0 and number_of_VLRs from
+                                      the LAS header)
+                - vlr_data       =    The returned unsigned character data array.
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_VLR_RECORD_NUMBER_ERROR
+                - LIBSLAS_VLR_READ_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+*********************************************************************************************/
+
+int32_t libslas_read_vlr_data (int32_t hnd, int32_t recnum, uint8_t *vlr_data)
+{
+  int32_t             i;
+  int64_t             addr;
+  LIBSLAS_VLR_HEADER  hdr;
+  uint16_t            tmp_short;
+  double              tmp_double;
+
+
+  /*  Check for record out of bounds.  */
+
+  if (recnum >= LAS (hnd).header.number_of_VLRs || recnum < 0)
+    {
+      sprintf (libslas_error.info, _("File : %s\nVLR Record : %d\nInvalid VLR record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_VLR_RECORD_NUMBER_ERROR);
+    }
+
+
+  if (libslas_find_vlr_header (hnd, recnum, &hdr, &addr)) return (libslas_error.libslas);
+
+
+  /*  If we're creating the file the VLRs may still be in the stdio buffer.  */
+
+  if (LAS (hnd).created) fflush (LAS (hnd).fp);
+
+
+  /*  The data follows the header.  */
+
+  if (libslas_pread (hnd, addr + VLR_HEADER_SIZE, vlr_data, hdr.record_length_after_header))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError reading VLR data :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_READ_ERROR);
+    }
+
+
+  /*  Swap things if we need to.  */
+
+  if (LAS (hnd).swap)
+    {
+      switch (hdr.record_id)
+        {
+        case 34735:
+          for (i = 0 ; i < hdr.record_length_after_header ; i += 2)
+            {
+              memcpy (&vlr_data[i], &tmp_short, 2);
+              libslas_swap_uint16_t (&tmp_short);
+              memcpy (&tmp_short, &vlr_data[i], 2);
+            }
+          break;
+
+        case 34736:
+          for (i = 0 ; i < hdr.record_length_after_header ; i += 8)
+            {
+              memcpy (&vlr_data[i], &tmp_double, 8);
+              libslas_swap_double (&tmp_double);
+              memcpy (&tmp_double, &vlr_data[i], 8);
+            }
+          break;
+        }
+    }
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/*********************************************************************************************/
+/*!
+
+ - Function:    libslas_find_vlr
+
+ - Purpose:     Finds a VLR record by user ID and record ID.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - user_id        =    The VLR user ID (e.g. "LASF_Projection")
+                - record_id      =    The VLR record ID (e.g. 34735 for the GeoKeyDirectoryTag)
+                - vlr_header     =    The returned LIBSLAS VLR header
+
+ - Returns:
+                - The VLR record number (0 or positive)
+                - LIBSLAS_VLR_NOT_FOUND_ERROR
+                - LIBSLAS_VLR_READ_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                Use the returned record number with libslas_read_vlr_data to get the contents
+                of the VLR.  All of the VLR headers are read when the file is opened so this
+                just looks through them, it doesn't do any I/O.  If there is more than one
+                matching VLR you get the first one.
+
+*********************************************************************************************/
+
+int32_t libslas_find_vlr (int32_t hnd, char *user_id, uint16_t record_id, LIBSLAS_VLR_HEADER *vlr_header)
+{
+  int32_t i;
+
+
+  for (i = 0 ; i < LAS_COLD (hnd).vlr_count ; i++)
+    {
+      if (LAS_COLD (hnd).vlr[i].header.record_id == record_id && !strncmp (LAS_COLD (hnd).vlr[i].header.user_id, user_id, 16))
+        {
+          *vlr_header = LAS_COLD (hnd).vlr[i].header;
+          return (i);
+        }
+    }
+
+
+  sprintf (libslas_error.info, _("File : %s\nVLR record %s %d not found.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, user_id, record_id,
+           __FUNCTION__, __LINE__ - 1);
+  return (libslas_error.libslas = LIBSLAS_VLR_NOT_FOUND_ERROR);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_append_vlr_record
+
+ - Purpose:     Appends a LAS Variable length record to the LAS file (after the header).
+
+ - Author:      Jan C. Depner (area.based.editor@gmail.com)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - hnd            =    The file handle
+                - vlr_header     =    The LIBSLAS_VLR_HEADER structure (see libslas.h)
+                - vlr_data       =    An unsigned character array containing the data for the VLR.
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_VLR_APPEND_ERROR
+                - LIBSLAS_VLR_WRITE_FSEEK_ERROR
+                - LIBSLAS_VLR_WRITE_ERROR
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+
+ - Caveats:     This function is ONLY used to append a new vlr record to a file as it is being
+                created.  VLR records must be written prior to and point data records so that
+                the API can keep track of the needed data offset value.
+
+                All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+*********************************************************************************************/
+
+int32_t libslas_append_vlr_record (int32_t hnd, LIBSLAS_VLR_HEADER *vlr_header, uint8_t *vlr_data)
+{
+  int32_t   i, rec_length;
+  uint16_t  tmp_short;
+  double    tmp_double;
+  VLR_ENTRY *vlr;
+
+
+  /*  Appending a VLR is only allowed if you are creating a new file and you haven't written any point records.  */
+
+  if (!LAS (hnd).created)
+    {
+      sprintf (libslas_error.info, _("File : %s\nAppending VLR records pre-existing LAS file not allowed.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_APPEND_ERROR);
+    }
+
+
+  if (LAS (hnd).data)
+    {
+      sprintf (libslas_error.info, _("File : %s\nVLR records can not be added after writing any point data records.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_APPEND_ERROR);
+    }
+
+
+  /*  If we're not already at the end of the file...  */
+
+  if (!LAS (hnd).at_end)
+    {
+      /*  We're appending so we need to seek to the end of what we've written.  */
+
+      if (fseeko64 (LAS (hnd).fp, LAS (hnd).pos, SEEK_SET) < 0)
+        {
+          sprintf (libslas_error.info, _("File : %s\nError during fseek prior to writing VLR record :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_VLR_WRITE_FSEEK_ERROR);
+        }
+    }
+
+
+  LAS (hnd).at_end = 1;
+
+
+  /*  Set reserved field to 0.  */
+
+  vlr_header->reserved = 0;
+
+
+  rec_length = vlr_header->record_length_after_header;
+
+
+  /*  Add it to the VLR directory (before we swap anything).  */
+
+  if ((vlr = (VLR_ENTRY *) realloc (LAS_COLD (hnd).vlr, (size_t) (LAS_COLD (hnd).vlr_count + 1) * sizeof (VLR_ENTRY))) == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nUnable to allocate memory for the VLR directory :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_MEMORY_ALLOCATION_ERROR);
+    }
+
+  LAS_COLD (hnd).vlr = vlr;
+  LAS_COLD (hnd).vlr[LAS_COLD (hnd).vlr_count].header = *vlr_header;
+  LAS_COLD (hnd).vlr[LAS_COLD (hnd).vlr_count].addr = LAS (hnd).pos;
+  LAS_COLD (hnd).vlr_count++;
+
+
+  /*  Swap things if we need to.  */
+
+  if (LAS (hnd).swap)
+    {
+      switch (vlr_header->record_id)
+        {
+        case 34735:
+          for (i = 0 ; i < vlr_header->record_length_after_header ; i += 2)
+            {
+              memcpy (&vlr_data[i], &tmp_short, 2);
+              libslas_swap_uint16_t (&tmp_short);
+              memcpy (&tmp_short, &vlr_data[i], 2);
+            }
+          break;
+
+        case 34736:
+          for (i = 0 ; i < vlr_header->record_length_after_header ; i += 8)
+            {
+              memcpy (&vlr_data[i], &tmp_double, 8);
+              libslas_swap_double (&tmp_double);
+              memcpy (&tmp_double, &vlr_data[i], 8);
+            }
+          break;
+        }
+
+      libslas_swap_uint16_t (&vlr_header->record_id);
+      libslas_swap_uint16_t (&vlr_header->record_length_after_header);
+    }
+
+
+  if (!fwrite (&vlr_header->reserved, 2, 1, LAS (hnd).fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (reserved) :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
+    }
+
+  if (!fwrite (&vlr_header->user_id, 16, 1, LAS (hnd).fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (user id) :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
+    }
+
+  if (!fwrite (&vlr_header->record_id, 2, 1, LAS (hnd).fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (record id) :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
+    }
+
+  if (!fwrite (&vlr_header->record_length_after_header, 2, 1, LAS (hnd).fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (record length) :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
+    }
+
+  if (!fwrite (&vlr_header->description, 32, 1, LAS (hnd).fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing VLR header (description) :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
+    }
+
+  if (!fwrite (vlr_data, rec_length, 1, LAS (hnd).fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing VLR data :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_VLR_WRITE_ERROR);
+    }
+
+
+  /*  Set the offset to the point data to be just after the last VLR written.  */
+
+  LAS (hnd).pos = LAS (hnd).header.offset_to_point_data = ftello64 (LAS (hnd).fp);
+
+  LAS (hnd).at_end = 1;
+  LAS (hnd).write = 1;
+
+
+#ifdef LIBSLAS_DEBUG
+  fprintf (LIBSLAS_DEBUG_OUTPUT, "%s %s %d\n", __FILE__, __FUNCTION__, __LINE__);
+  fflush (LIBSLAS_DEBUG_OUTPUT);
+#endif
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_unpack_point_data
+
+ - Purpose:     Unpacks a raw LAS point data record into a LIBSLAS_POINT_DATA structure.
+
+ - Author:      agent (agent@local)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - hnd            =    The file handle
+                - data           =    The raw point data record as read from the file
+                - record         =    The returned LAS point data record
+
+ - Returns:
+                - void
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_unpack_point_data (int32_t hnd, uint8_t *data, LIBSLAS_POINT_DATA *record)
+{
+  int32_t  x, y, z, pos;
+  uint8_t  rets, cls;
+
+
+  memset (record, 0, sizeof (LIBSLAS_POINT_DATA));
+
+
+  /*  Get the data out of the buffer.  */
+
+  pos = 0;
+  memcpy (&x, &data[pos], 4); pos += 4;
+  memcpy (&y, &data[pos], 4); pos += 4;
+  memcpy (&z, &data[pos], 4); pos += 4;
+  memcpy (&record->intensity, &data[pos], 2); pos += 2;
+  memcpy (&rets, &data[pos], 1); pos += 1;
+  memcpy (&cls, &data[pos], 1); pos += 1;
+  memcpy (&record->scan_angle_rank, &data[pos], 1); pos += 1;
+  memcpy (&record->user_data, &data[pos], 1); pos += 1;
+  memcpy (&record->point_source_id, &data[pos], 2); pos += 2;
+
+
+  switch (LAS (hnd).header.point_data_format_id)
+    {
+    case 1:
+      memcpy (&record->gps_time, &data[pos], 8); pos += 8;
+      break;
+
+    case 2:
+      memcpy (&record->red, &data[pos], 2); pos += 2;
+      memcpy (&record->green, &data[pos], 2); pos += 2;
+      memcpy (&record->blue, &data[pos], 2); pos += 2;
+      break;
+
+    case 3:
+      memcpy (&record->gps_time, &data[pos], 8); pos += 8;
+      memcpy (&record->red, &data[pos], 2); pos += 2;
+      memcpy (&record->green, &data[pos], 2); pos += 2;
+      memcpy (&record->blue, &data[pos], 2); pos += 2;
+      break;
+    }
+
+
+  /*  If we have to swap the record, do so.  */
+
+  if (LAS (hnd).swap)
+    {
+      libslas_swap_uint32_t ((uint32_t *) &x);
+      libslas_swap_uint32_t ((uint32_t *) &y);
+      libslas_swap_uint32_t ((uint32_t *) &z);
+      libslas_swap_uint16_t (&record->intensity);
+      libslas_swap_uint16_t (&record->point_source_id);
+
+      switch (LAS (hnd).header.point_data_format_id)
+        {
+        case 1:
+          libslas_swap_double (&record->gps_time);
+          break;
+
+        case 2:
+          libslas_swap_uint16_t (&record->red);
+          libslas_swap_uint16_t (&record->green);
+          libslas_swap_uint16_t (&record->blue);
+          break;
+
+        case 3:
+          libslas_swap_double (&record->gps_time);
+          libslas_swap_uint16_t (&record->red);
+          libslas_swap_uint16_t (&record->green);
+          libslas_swap_uint16_t (&record->blue);
+          break;
+        }
+    }
+
+
+  /*  Now put the rest of the data into the structure.  */
+
+  record->x = ((double) x * LAS (hnd).header.x_scale_factor) + LAS (hnd).header.x_offset;
+  record->y = ((double) y * LAS (hnd).header.y_scale_factor) + LAS (hnd).header.y_offset;
+  record->z = (float) (((double) z * LAS (hnd).header.z_scale_factor) + LAS (hnd).header.z_offset);
+  record->return_number = rets & 0x07;
+  record->number_of_returns = (rets & 0x38) >> 3;
+  record->edge_of_flightline = (rets & 0x40) >> 6;
+  record->scan_direction_flag = (rets & 0x80) >> 7;
+  record->classification = cls & 0x1f;
+  record->synthetic = (cls & 0x20) >> 5;
+  record->key_point = (cls & 0x40) >> 6;
+  record->withheld = (cls & 0x80) >> 7;
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_pack_point_data
+
+ - Purpose:     Packs a LIBSLAS_POINT_DATA structure into a raw LAS point data record.
+
+ - Author:      agent (agent@local)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - hnd            =    The file handle
+                - record         =    The LIBSLAS_POINT_DATA structure to be packed
+                - data           =    The returned raw point data record (at least
+                                      POINT_DATA_SIZE bytes)
+
+ - Returns:
+                - void
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_pack_point_data (int32_t hnd, LIBSLAS_POINT_DATA *record, uint8_t *data)
+{
+  int32_t   x, y, z, pos;
+  uint16_t  intensity, psid, red, green, blue;
+  uint8_t   rets, cls;
+  double    gps_time;
+
+
+  /*  Get the data out of the structure.  */
+
+  x = NINT64 ((record->x - LAS (hnd).header.x_offset) / LAS (hnd).header.x_scale_factor);
+  y = NINT64 ((record->y - LAS (hnd).header.y_offset) / LAS (hnd).header.y_scale_factor);
+  z = NINT64 ((record->z - LAS (hnd).header.z_offset) / LAS (hnd).header.z_scale_factor);
+  intensity = record->intensity;
+  psid = record->point_source_id;
+  gps_time = record->gps_time;
+  red = record->red;
+  green = record->green;
+  blue = record->blue;
+
+
+  /*  Pack the bit fields.  */
+
+  rets = 0;
+  rets |= record->return_number;
+  rets |= (record->number_of_returns << 3);
+  rets |= (record->edge_of_flightline << 6);
+  rets |= (record->scan_direction_flag << 7);
+  cls = 0;
+  cls |= record->classification;
+  cls |= (record->withheld << 7);
+  cls |= (record->key_point << 6);
+  cls |= (record->synthetic << 5);
+
+
+  /*  If we have to swap the record, do so.  */
+
+  if (LAS (hnd).swap)
+    {
+      libslas_swap_uint32_t ((uint32_t *) &x);
+      libslas_swap_uint32_t ((uint32_t *) &y);
+      libslas_swap_uint32_t ((uint32_t *) &z);
+      libslas_swap_uint16_t (&intensity);
+      libslas_swap_uint16_t (&psid);
+      libslas_swap_double (&gps_time);
+      libslas_swap_uint16_t (&red);
+      libslas_swap_uint16_t (&green);
+      libslas_swap_uint16_t (&blue);
+    }
+
+
+  /*  Put the data into the buffer.  */
+
+  pos = 0;
+  memcpy (&data[pos], &x, 4); pos += 4;
+  memcpy (&data[pos], &y, 4); pos += 4;
+  memcpy (&data[pos], &z, 4); pos += 4;
+  memcpy (&data[pos], &intensity, 2); pos += 2;
+  memcpy (&data[pos], &rets, 1); pos += 1;
+  memcpy (&data[pos], &cls, 1); pos += 1;
+  memcpy (&data[pos], &record->scan_angle_rank, 1); pos += 1;
+  memcpy (&data[pos], &record->user_data, 1); pos += 1;
+  memcpy (&data[pos], &psid, 2); pos += 2;
+
+
+  switch (LAS (hnd).header.point_data_format_id)
+    {
+    case 1:
+      memcpy (&data[pos], &gps_time, 8); pos += 8;
+      break;
+
+    case 2:
+      memcpy (&data[pos], &red, 2); pos += 2;
+      memcpy (&data[pos], &green, 2); pos += 2;
+      memcpy (&data[pos], &blue, 2); pos += 2;
+      break;
+
+    case 3:
+      memcpy (&data[pos], &gps_time, 8); pos += 8;
+      memcpy (&data[pos], &red, 2); pos += 2;
+      memcpy (&data[pos], &green, 2); pos += 2;
+      memcpy (&data[pos], &blue, 2); pos += 2;
+      break;
+    }
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_pack_modifiable_fields
+
+ - Purpose:     Packs the user modifiable fields of a LIBSLAS_POINT_DATA structure into an
+                existing raw point data record without affecting the "non-modifiable" fields.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - record         =    The LIBSLAS_POINT_DATA structure containing the new values
+                - data           =    The raw point data record to be modified
+
+ - Returns:
+                - void
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_pack_modifiable_fields (int32_t hnd, LIBSLAS_POINT_DATA *record, uint8_t *data)
+{
+  int32_t   pos;
+  uint16_t  psid, red, green, blue;
+  uint8_t   cls;
+
+
+  /*  Modify the fields that can be changed (see libslas.h)  */
+
+  cls = 0;
+  cls |= record->classification;
+  cls |= (record->withheld << 7);
+  cls |= (record->key_point << 6);
+  cls |= (record->synthetic << 5);
+
+
+  /*  Position to the classification field.  */
+
+  pos = 15;
+  memcpy (&data[pos], &cls, 1); pos += 1;
+
+
+  /*  Move past the scan_angle_rank field.  */
+
+  pos +=1;
+  memcpy (&data[pos], &record->user_data, 1); pos += 1;
+
+
+  /*  Swap the point source ID if needed.  */
+
+  psid = record->point_source_id;
+  if (LAS (hnd).swap) libslas_swap_uint16_t (&psid);
+  memcpy (&data[pos], &psid, 2); pos += 2;
+
+
+  red = record->red;
+  green = record->green;
+  blue = record->blue;
+
+  if (LAS (hnd).header.point_data_format_id > 1)
+    {
+      /*  If we're using format 3, move past the GPS time.  */
+
+      if (LAS (hnd).header.point_data_format_id == 3) pos += 8;
+
+
+      /*  Swap if we have to.  */
+
+      if (LAS (hnd).swap)
+        {
+          libslas_swap_uint16_t (&red);
+          libslas_swap_uint16_t (&green);
+          libslas_swap_uint16_t (&blue);
+        }
+
+      memcpy (&data[pos], &red, 2); pos += 2;
+      memcpy (&data[pos], &green, 2); pos += 2;
+      memcpy (&data[pos], &blue, 2); pos += 2;
+    }
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_point_data
+
+ - Purpose:     Retrieve a LAS point data record.
+
+ - Author:      Jan C. Depner (area.based.editor@gmail.com)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the LAS point data record to be
+                                      retrieved (records start at 0)
+                - record         =    The returned LAS point data record
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_READ_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                Note that we only have one point data format structure.  Since each of the 
+                point data formats was a subset of POINT DATA RECORD FORMAT 3 it's much easier
+                to just deal with one format.  If you happen to read a POINT DATA RECORD
                 FORMAT 0 record then gps_time, red, green, and blue will be set to 0.  These
                 records are so tiny that I'm not worried about the wasted space in memory.
                 If you read a billion FORMAT 0 records into memory (which would be a very
@@ -1395,342 +4117,3887 @@ int32_t libslas_append_vlr_record (int32_t hnd, LIBSLAS_VLR_HEADER *vlr_header,
 
 *********************************************************************************************/
 
-int32_t libslas_read_point_data (int32_t hnd, int32_t recnum, LIBSLAS_POINT_DATA *record)
+int32_t libslas_read_point_data (int32_t hnd, int32_t recnum, LIBSLAS_POINT_DATA *record)
+{
+  int32_t  num;
+  int64_t  addr;
+  uint8_t  data[POINT_DATA_SIZE], *raw;
+
+
+  /*  Check for record out of bounds.  */
+
+  if (recnum >= LAS (hnd).header.number_of_point_records || recnum < 0)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  /*  If the point data is memory mapped just unpack the record from the map.  */
+
+  if (LAS (hnd).points != NULL)
+    {
+      libslas_unpack_point_data (hnd, &LAS (hnd).points[(size_t) LAS (hnd).header.point_data_record_length * (size_t) recnum], record);
+
+      return (LIBSLAS_SUCCESS);
+    }
+
+
+  /*  If we're reading ahead, unpack the record from the read-ahead buffer (if it's there).  */
+
+  num = 1;
+  if (LAS (hnd).ra != NULL && (raw = libslas_read_ahead_record (hnd, recnum, &num)) != NULL)
+    {
+      libslas_unpack_point_data (hnd, raw, record);
+
+      return (LIBSLAS_SUCCESS);
+    }
+
+
+  /*  Make sure any buffered point data has been written.  */
+
+  if (libslas_flush_point_buffer (hnd, 0)) return (libslas_error.libslas);
+
+
+  addr = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) recnum;
+
+
+  memset (data, 0, POINT_DATA_SIZE);
+
+
+  /*  Read the record.  */
+
+  if (libslas_pread (hnd, addr, data, MIN (LAS (hnd).header.point_data_record_length, POINT_DATA_SIZE)))
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nError reading LAS record :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_READ_ERROR);
+    }
+
+
+  /*  Unpack the record.  */
+
+  libslas_unpack_point_data (hnd, data, record);
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_unpack_point_columns
+
+ - Purpose:     Unpacks a block of raw LAS point data records into the application's column
+                arrays.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - data           =    The raw point data records
+                - first          =    Index in the column arrays of the first record in data
+                - count          =    Number of records in data
+                - columns        =    The LIBSLAS_POINT_COLUMNS structure
+
+ - Returns:
+                - void
+
+ - Caveats:     Each column is done in its own loop so we only touch the bytes of the raw
+                records (and the column arrays) that the application actually asked for.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_unpack_point_columns (int32_t hnd, uint8_t *data, int32_t first, int32_t count, LIBSLAS_POINT_COLUMNS *columns)
+{
+  int32_t   i, rec_length, ival, gps_pos, rgb_pos;
+  uint16_t  sval;
+  uint8_t   *raw;
+  double    dval;
+
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+
+
+  /*  GPS time and RGB positions depend on the point data format (0 means the field isn't there).  */
+
+  gps_pos = rgb_pos = 0;
+
+  switch (LAS (hnd).header.point_data_format_id)
+    {
+    case 1:
+      gps_pos = 20;
+      break;
+
+    case 2:
+      rgb_pos = 20;
+      break;
+
+    case 3:
+      gps_pos = 20;
+      rgb_pos = 28;
+      break;
+    }
+
+
+  if (columns->x != NULL)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&ival, raw, 4);
+          if (LAS (hnd).swap) libslas_swap_uint32_t ((uint32_t *) &ival);
+          columns->x[first + i] = ((double) ival * LAS (hnd).header.x_scale_factor) + LAS (hnd).header.x_offset;
+        }
+    }
+
+  if (columns->y != NULL)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&ival, &raw[4], 4);
+          if (LAS (hnd).swap) libslas_swap_uint32_t ((uint32_t *) &ival);
+          columns->y[first + i] = ((double) ival * LAS (hnd).header.y_scale_factor) + LAS (hnd).header.y_offset;
+        }
+    }
+
+  if (columns->z != NULL)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&ival, &raw[8], 4);
+          if (LAS (hnd).swap) libslas_swap_uint32_t ((uint32_t *) &ival);
+          columns->z[first + i] = (float) (((double) ival * LAS (hnd).header.z_scale_factor) + LAS (hnd).header.z_offset);
+        }
+    }
+
+  if (columns->intensity != NULL)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&sval, &raw[12], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          columns->intensity[first + i] = sval;
+        }
+    }
+
+  if (columns->return_number != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->return_number[first + i] = raw[14] & 0x07;
+
+  if (columns->number_of_returns != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->number_of_returns[first + i] = (raw[14] & 0x38) >> 3;
+
+  if (columns->edge_of_flightline != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->edge_of_flightline[first + i] = (raw[14] & 0x40) >> 6;
+
+  if (columns->scan_direction_flag != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->scan_direction_flag[first + i] = (raw[14] & 0x80) >> 7;
+
+  if (columns->classification != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->classification[first + i] = raw[15] & 0x1f;
+
+  if (columns->synthetic != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->synthetic[first + i] = (raw[15] & 0x20) >> 5;
+
+  if (columns->key_point != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->key_point[first + i] = (raw[15] & 0x40) >> 6;
+
+  if (columns->withheld != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->withheld[first + i] = (raw[15] & 0x80) >> 7;
+
+  if (columns->scan_angle_rank != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->scan_angle_rank[first + i] = (int8_t) raw[16];
+
+  if (columns->user_data != NULL)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) columns->user_data[first + i] = raw[17];
+
+  if (columns->point_source_id != NULL)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&sval, &raw[18], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          columns->point_source_id[first + i] = sval;
+        }
+    }
+
+  if (columns->gps_time != NULL)
+    {
+      if (gps_pos)
+        {
+          for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+            {
+              memcpy (&dval, &raw[gps_pos], 8);
+              if (LAS (hnd).swap) libslas_swap_double (&dval);
+              columns->gps_time[first + i] = dval;
+            }
+        }
+      else
+        {
+          for (i = 0 ; i < count ; i++) columns->gps_time[first + i] = 0.0;
+        }
+    }
+
+  if (columns->red != NULL)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          sval = 0;
+          if (rgb_pos) memcpy (&sval, &raw[rgb_pos], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          columns->red[first + i] = sval;
+        }
+    }
+
+  if (columns->green != NULL)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          sval = 0;
+          if (rgb_pos) memcpy (&sval, &raw[rgb_pos + 2], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          columns->green[first + i] = sval;
+        }
+    }
+
+  if (columns->blue != NULL)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          sval = 0;
+          if (rgb_pos) memcpy (&sval, &raw[rgb_pos + 4], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          columns->blue[first + i] = sval;
+        }
+    }
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_unpack_point_fields
+
+ - Purpose:     Unpacks the requested fields of a block of raw LAS point data records into an
+                array of LIBSLAS_POINT_DATA structures.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - data           =    The raw point data records
+                - count          =    Number of records in data
+                - records        =    The returned LAS point data records
+                - fields         =    Bit mask of LIBSLAS_FIELD_* values
+
+ - Returns:
+                - void
+
+ - Caveats:     Fields that aren't requested are left alone in the records.  Like
+                libslas_unpack_point_columns, each field gets its own loop so that only the
+                requested bytes of the raw records are ever touched.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_unpack_point_fields (int32_t hnd, uint8_t *data, int32_t count, LIBSLAS_POINT_DATA *records, uint32_t fields)
+{
+  int32_t   i, rec_length, ival, gps_pos, rgb_pos;
+  uint16_t  sval;
+  uint8_t   *raw;
+  double    dval;
+
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+
+
+  /*  GPS time and RGB positions depend on the point data format (0 means the field isn't there).  */
+
+  gps_pos = rgb_pos = 0;
+
+  switch (LAS (hnd).header.point_data_format_id)
+    {
+    case 1:
+      gps_pos = 20;
+      break;
+
+    case 2:
+      rgb_pos = 20;
+      break;
+
+    case 3:
+      gps_pos = 20;
+      rgb_pos = 28;
+      break;
+    }
+
+
+  if (fields & LIBSLAS_FIELD_X)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&ival, raw, 4);
+          if (LAS (hnd).swap) libslas_swap_uint32_t ((uint32_t *) &ival);
+          records[i].x = ((double) ival * LAS (hnd).header.x_scale_factor) + LAS (hnd).header.x_offset;
+        }
+    }
+
+  if (fields & LIBSLAS_FIELD_Y)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&ival, &raw[4], 4);
+          if (LAS (hnd).swap) libslas_swap_uint32_t ((uint32_t *) &ival);
+          records[i].y = ((double) ival * LAS (hnd).header.y_scale_factor) + LAS (hnd).header.y_offset;
+        }
+    }
+
+  if (fields & LIBSLAS_FIELD_Z)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&ival, &raw[8], 4);
+          if (LAS (hnd).swap) libslas_swap_uint32_t ((uint32_t *) &ival);
+          records[i].z = (float) (((double) ival * LAS (hnd).header.z_scale_factor) + LAS (hnd).header.z_offset);
+        }
+    }
+
+  if (fields & LIBSLAS_FIELD_INTENSITY)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&sval, &raw[12], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          records[i].intensity = sval;
+        }
+    }
+
+  if (fields & LIBSLAS_FIELD_RETURN_NUMBER)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].return_number = raw[14] & 0x07;
+
+  if (fields & LIBSLAS_FIELD_NUMBER_OF_RETURNS)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].number_of_returns = (raw[14] & 0x38) >> 3;
+
+  if (fields & LIBSLAS_FIELD_EDGE_OF_FLIGHTLINE)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].edge_of_flightline = (raw[14] & 0x40) >> 6;
+
+  if (fields & LIBSLAS_FIELD_SCAN_DIRECTION_FLAG)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].scan_direction_flag = (raw[14] & 0x80) >> 7;
+
+  if (fields & LIBSLAS_FIELD_CLASSIFICATION)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].classification = raw[15] & 0x1f;
+
+  if (fields & LIBSLAS_FIELD_SYNTHETIC)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].synthetic = (raw[15] & 0x20) >> 5;
+
+  if (fields & LIBSLAS_FIELD_KEY_POINT)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].key_point = (raw[15] & 0x40) >> 6;
+
+  if (fields & LIBSLAS_FIELD_WITHHELD)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].withheld = (raw[15] & 0x80) >> 7;
+
+  if (fields & LIBSLAS_FIELD_SCAN_ANGLE_RANK)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].scan_angle_rank = (int8_t) raw[16];
+
+  if (fields & LIBSLAS_FIELD_USER_DATA)
+    for (i = 0, raw = data ; i < count ; i++, raw += rec_length) records[i].user_data = raw[17];
+
+  if (fields & LIBSLAS_FIELD_POINT_SOURCE_ID)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          memcpy (&sval, &raw[18], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          records[i].point_source_id = sval;
+        }
+    }
+
+  if (fields & LIBSLAS_FIELD_GPS_TIME)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          dval = 0.0;
+          if (gps_pos) memcpy (&dval, &raw[gps_pos], 8);
+          if (LAS (hnd).swap) libslas_swap_double (&dval);
+          records[i].gps_time = dval;
+        }
+    }
+
+  if (fields & LIBSLAS_FIELD_RED)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          sval = 0;
+          if (rgb_pos) memcpy (&sval, &raw[rgb_pos], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          records[i].red = sval;
+        }
+    }
+
+  if (fields & LIBSLAS_FIELD_GREEN)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          sval = 0;
+          if (rgb_pos) memcpy (&sval, &raw[rgb_pos + 2], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          records[i].green = sval;
+        }
+    }
+
+  if (fields & LIBSLAS_FIELD_BLUE)
+    {
+      for (i = 0, raw = data ; i < count ; i++, raw += rec_length)
+        {
+          sval = 0;
+          if (rgb_pos) memcpy (&sval, &raw[rgb_pos + 4], 2);
+          if (LAS (hnd).swap) libslas_swap_uint16_t (&sval);
+          records[i].blue = sval;
+        }
+    }
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_point_block
+
+ - Purpose:     Reads a block of consecutive raw point data records with a single read.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the first record to be read
+                - count          =    The number of records to be read
+                - buffer         =    The returned raw records (count * point_data_record_length
+                                      bytes)
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_READ_ERROR
+
+ - Caveats:     The caller has to check that the records are in bounds.
+
+                If the file is being read ahead we copy whatever we can from the read-ahead
+                buffers and only read the rest.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_read_point_block (int32_t hnd, int32_t recnum, int32_t count, uint8_t *buffer)
+{
+  int32_t  num;
+  int64_t  addr;
+  uint8_t  *raw;
+
+
+  if (LAS (hnd).ra != NULL)
+    {
+      while (count)
+        {
+          num = count;
+          if ((raw = libslas_read_ahead_record (hnd, recnum, &num)) == NULL) break;
+
+          num = MIN (num, count);
+          memcpy (buffer, raw, (size_t) LAS (hnd).header.point_data_record_length * (size_t) num);
+
+          buffer += (size_t) LAS (hnd).header.point_data_record_length * (size_t) num;
+          recnum += num;
+          count -= num;
+        }
+
+      if (!count) return (LIBSLAS_SUCCESS);
+    }
+
+
+  /*  Make sure any buffered point data has been written.  */
+
+  if (libslas_flush_point_buffer (hnd, 0)) return (libslas_error.libslas);
+
+
+  addr = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) recnum;
+
+
+  if (libslas_pread (hnd, addr, buffer, (size_t) LAS (hnd).header.point_data_record_length * (size_t) count))
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecords : %d through %d\nError reading LAS records :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               recnum + count - 1, strerror (errno), __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_READ_ERROR);
+    }
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_point_data_range
+
+ - Purpose:     Retrieve a range of consecutive LAS point data records.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the first LAS point data record to be
+                                      retrieved (records start at 0)
+                - count          =    The number of records to be retrieved
+                - records        =    The returned LAS point data records.  This must be an array
+                                      of at least count LIBSLAS_POINT_DATA structures.
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_READ_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                The raw records are read with a single read into the tail end of the caller's
+                records array and then unpacked, front to back, in place.  Since an unpacked
+                LIBSLAS_POINT_DATA structure is always at least as large as a packed record,
+                unpacking record N can never overwrite packed record N + 1.  That way we get
+                one large read without having to allocate a buffer in the API.  If the file's
+                point_data_record_length is larger than a LIBSLAS_POINT_DATA structure (i.e.
+                someone stuffed a lot of extra bytes in each record) we fall back to reading
+                POINT_BLOCK_SIZE bytes at a time into a local buffer.
+
+*********************************************************************************************/
+
+int32_t libslas_read_point_data_range (int32_t hnd, int32_t recnum, int32_t count, LIBSLAS_POINT_DATA *records)
+{
+  int32_t  i, j, rec_length, block_count, num;
+  uint8_t  data[POINT_DATA_SIZE], block[POINT_BLOCK_SIZE], *raw;
+
+
+  /*  Check for records out of bounds.  */
+
+  if (recnum < 0 || count < 0 || (int64_t) recnum + (int64_t) count > (int64_t) LAS (hnd).header.number_of_point_records)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecords : %d through %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               recnum + count - 1, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  if (!count) return (LIBSLAS_SUCCESS);
+
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+
+
+  /*  If the point data is memory mapped just unpack the records from the map.  */
+
+  if (LAS (hnd).points != NULL)
+    {
+      raw = &LAS (hnd).points[(size_t) rec_length * (size_t) recnum];
+
+      for (i = 0 ; i < count ; i++) libslas_unpack_point_data (hnd, &raw[(size_t) i * (size_t) rec_length], &records[i]);
+
+      return (LIBSLAS_SUCCESS);
+    }
+
+
+  memset (data, 0, POINT_DATA_SIZE);
+
+
+  if (rec_length <= sizeof (LIBSLAS_POINT_DATA))
+    {
+      /*  Read all of the records into the tail end of the caller's array.  */
+
+      raw = (uint8_t *) records + ((size_t) count * sizeof (LIBSLAS_POINT_DATA) - (size_t) count * (size_t) rec_length);
+
+      if (libslas_read_point_block (hnd, recnum, count, raw)) return (libslas_error.libslas);
+
+
+      /*  Unpack them front to back.  Each packed record has to be copied out before we unpack it since the unpacked
+          structure overlaps it.  */
+
+      for (i = 0 ; i < count ; i++)
+        {
+          memcpy (data, &raw[(size_t) i * (size_t) rec_length], MIN (rec_length, POINT_DATA_SIZE));
+          libslas_unpack_point_data (hnd, data, &records[i]);
+        }
+    }
+  else
+    {
+      /*  Huge records.  Read them a block at a time (a record can never be larger than POINT_BLOCK_SIZE).  */
+
+      block_count = POINT_BLOCK_SIZE / rec_length;
+
+      for (i = 0 ; i < count ; i += num)
+        {
+          num = MIN (block_count, count - i);
+
+          if (libslas_read_point_block (hnd, recnum + i, num, block)) return (libslas_error.libslas);
+
+          for (j = 0 ; j < num ; j++) libslas_unpack_point_data (hnd, &block[j * rec_length], &records[i + j]);
+        }
+    }
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_point_columns
+
+ - Purpose:     Retrieve a range of consecutive LAS point data records into separate, application
+                supplied, column arrays.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the first LAS point data record to be
+                                      retrieved (records start at 0)
+                - count          =    The number of records to be retrieved
+                - columns        =    LIBSLAS_POINT_COLUMNS structure containing pointers to the
+                                      arrays to be filled.  Each non-NULL array must have room for
+                                      count values.  NULL arrays are skipped.
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_READ_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                This is meant for gridding and statistics code that wants to run through one
+                or two fields of a lot of points in contiguous memory.  As with reading a
+                LIBSLAS_POINT_DATA structure, gps_time, red, green, and blue will be set to 0 if
+                they aren't in the file's point data format.
+
+*********************************************************************************************/
+
+int32_t libslas_read_point_columns (int32_t hnd, int32_t recnum, int32_t count, LIBSLAS_POINT_COLUMNS *columns)
+{
+  int32_t  i, rec_length, block_count, num;
+  uint8_t  block[POINT_BLOCK_SIZE];
+
+
+  /*  Check for records out of bounds.  */
+
+  if (recnum < 0 || count < 0 || (int64_t) recnum + (int64_t) count > (int64_t) LAS (hnd).header.number_of_point_records)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecords : %d through %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               recnum + count - 1, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+
+
+  /*  If the point data is memory mapped just unpack the records from the map.  */
+
+  if (LAS (hnd).points != NULL)
+    {
+      if (count) libslas_unpack_point_columns (hnd, &LAS (hnd).points[(size_t) rec_length * (size_t) recnum], 0, count, columns);
+
+      return (LIBSLAS_SUCCESS);
+    }
+
+
+  /*  Otherwise read and unpack a block at a time.  */
+
+  block_count = POINT_BLOCK_SIZE / rec_length;
+
+  for (i = 0 ; i < count ; i += num)
+    {
+      num = MIN (block_count, count - i);
+
+      if (libslas_read_point_block (hnd, recnum + i, num, block)) return (libslas_error.libslas);
+
+      libslas_unpack_point_columns (hnd, block, i, num, columns);
+    }
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_point_data_fields
+
+ - Purpose:     Retrieve only some of the fields of a range of consecutive LAS point data
+                records.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the first LAS point data record to be
+                                      retrieved (records start at 0)
+                - count          =    The number of records to be retrieved (1 for a single
+                                      record)
+                - records        =    The returned LAS point data records.  This must be an array
+                                      of at least count LIBSLAS_POINT_DATA structures.
+                - fields         =    Bit mask of the fields to unpack (LIBSLAS_FIELD_X,
+                                      LIBSLAS_FIELD_CLASSIFICATION, LIBSLAS_FIELD_XYZ, etc.  See
+                                      libslas.h)
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_READ_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                Fields that weren't requested are NOT cleared, they are left exactly as they
+                were in the records you passed in.  If you only ask for
+                LIBSLAS_FIELD_CLASSIFICATION on a LIBSLAS_READONLY_MMAP file the only thing
+                that gets touched in each point record is byte 15.
+
+*********************************************************************************************/
+
+int32_t libslas_read_point_data_fields (int32_t hnd, int32_t recnum, int32_t count, LIBSLAS_POINT_DATA *records, uint32_t fields)
+{
+  int32_t  i, rec_length, block_count, num;
+  uint8_t  block[POINT_BLOCK_SIZE];
+
+
+  /*  Check for records out of bounds.  */
+
+  if (recnum < 0 || count < 0 || (int64_t) recnum + (int64_t) count > (int64_t) LAS (hnd).header.number_of_point_records)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecords : %d through %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               recnum + count - 1, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+
+
+  /*  If the point data is memory mapped just unpack the records from the map.  */
+
+  if (LAS (hnd).points != NULL)
+    {
+      if (count) libslas_unpack_point_fields (hnd, &LAS (hnd).points[(size_t) rec_length * (size_t) recnum], count, records, fields);
+
+      return (LIBSLAS_SUCCESS);
+    }
+
+
+  /*  Otherwise read and unpack a block at a time.  */
+
+  block_count = POINT_BLOCK_SIZE / rec_length;
+
+  for (i = 0 ; i < count ; i += num)
+    {
+      num = MIN (block_count, count - i);
+
+      if (libslas_read_point_block (hnd, recnum + i, num, block)) return (libslas_error.libslas);
+
+      libslas_unpack_point_fields (hnd, block, num, &records[i], fields);
+    }
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_point_data_batch
+
+ - Purpose:     Retrieve a set of (possibly scattered) LAS point data records.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - count          =    The number of records to be retrieved
+                - recnums        =    Array of count record numbers of the LAS point data records
+                                      to be retrieved (records start at 0)
+                - records        =    The returned LAS point data records.  This must be an array
+                                      of at least count LIBSLAS_POINT_DATA structures.  records[i]
+                                      is record number recnums[i].
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_READ_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                This is meant for bursts of random reads (picking points, fetching the
+                neighbors of a point, etc.).  If the file is using the LIBSLAS_IO_URING I/O
+                engine (see libslas_set_io_engine) the reads are submitted to the kernel
+                IO_BATCH_SIZE (256) at a time so they can all be in flight at once.  Otherwise
+                this is no faster than calling libslas_read_point_data for each record.  If you
+                want consecutive records use libslas_read_point_data_range.
+
+*********************************************************************************************/
+
+int32_t libslas_read_point_data_batch (int32_t hnd, int32_t count, int32_t *recnums, LIBSLAS_POINT_DATA *records)
+{
+  int32_t     i, j, num, length;
+  uint8_t     block[IO_BATCH_SIZE * POINT_DATA_SIZE];
+  IO_REQUEST  req[IO_BATCH_SIZE];
+
+
+  /*  Check for records out of bounds.  */
+
+  for (i = 0 ; i < count ; i++)
+    {
+      if (recnums[i] >= LAS (hnd).header.number_of_point_records || recnums[i] < 0)
+        {
+          sprintf (libslas_error.info, _("File : %s\nRecord : %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnums[i],
+                   __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+        }
+    }
+
+
+  /*  If the point data is memory mapped just unpack the records from the map.  */
+
+  if (LAS (hnd).points != NULL)
+    {
+      for (i = 0 ; i < count ; i++)
+        libslas_unpack_point_data (hnd, &LAS (hnd).points[(size_t) LAS (hnd).header.point_data_record_length * (size_t) recnums[i]], &records[i]);
+
+      return (LIBSLAS_SUCCESS);
+    }
+
+
+  /*  Make sure any buffered point data has been written.  */
+
+  if (libslas_flush_point_buffer (hnd, 0)) return (libslas_error.libslas);
+
+
+  length = MIN (LAS (hnd).header.point_data_record_length, POINT_DATA_SIZE);
+
+  memset (block, 0, sizeof (block));
+
+
+  for (i = 0 ; i < count ; i += num)
+    {
+      num = MIN (IO_BATCH_SIZE, count - i);
+
+      for (j = 0 ; j < num ; j++)
+        {
+          req[j].addr = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) recnums[i + j];
+          req[j].buffer = &block[j * POINT_DATA_SIZE];
+          req[j].length = length;
+        }
+
+
+      if (libslas_batch_io (hnd, req, num, 0))
+        {
+          sprintf (libslas_error.info, _("File : %s\nError reading LAS records :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+                   __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_READ_ERROR);
+        }
+
+
+      for (j = 0 ; j < num ; j++) libslas_unpack_point_data (hnd, &block[j * POINT_DATA_SIZE], &records[i + j]);
+    }
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_append_point_data
+
+ - Purpose:     Append a LAS point data record.
+
+ - Author:      Jan C. Depner (area.based.editor@gmail.com)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - hnd            =    The file handle
+                - record         =    The LIBSLAS_POINT_DATA structure to be written
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_APPEND_ERROR
+                - LIBSLAS_VALUE_OUT_OF_RANGE_ERROR
+                - LIBSLAS_WRITE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                This function is only used to append records when creating a file.  DO NOT
+                try to use it to update fields in the point data record.  It won't work.
+                Not only that but, if you were to read and write the x, y, and z fields
+                over and over you would continuously be aliasing them since they're scaled
+                offset integers.  The round off would cause data "creep".
+
+*********************************************************************************************/
+
+int32_t libslas_append_point_data (int32_t hnd, LIBSLAS_POINT_DATA *record)
+{
+  uint8_t  data[POINT_DATA_SIZE];
+
+
+  /*  Appending a record is only allowed if you are creating a new file or it was opened LIBSLAS_APPEND.  */
+
+  if (!LAS (hnd).created && !LAS (hnd).append)
+    {
+      sprintf (libslas_error.info, _("File : %s\nAppending to pre-existing LAS file not allowed unless it is opened LIBSLAS_APPEND.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_APPEND_ERROR);
+    }
+
+
+  /*  Once the point count has been declared the records have to be written with libslas_write_point_data.  */
+
+  if (LAS (hnd).parallel)
+    {
+      sprintf (libslas_error.info, _("File : %s\nCan't append point records after declaring the point count.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_APPEND_ERROR);
+    }
+
+
+  /*  Check for min and max x, y, and z since we're appending a record.  */
+
+  LAS (hnd).header.min_x = MIN (LAS (hnd).header.min_x, record->x);
+  LAS (hnd).header.max_x = MAX (LAS (hnd).header.max_x, record->x);
+  LAS (hnd).header.min_y = MIN (LAS (hnd).header.min_y, record->y);
+  LAS (hnd).header.max_y = MAX (LAS (hnd).header.max_y, record->y);
+  LAS (hnd).header.min_z = MIN (LAS (hnd).header.min_z, record->z);
+  LAS (hnd).header.max_z = MAX (LAS (hnd).header.max_z, record->z);
+
+
+  /*  Increment the number of records counter in the header.  */
+
+  LAS (hnd).header.number_of_point_records++;
+
+
+  /*  Check the return number.  */
+
+  if (record->return_number < 1 || record->return_number > 5)
+    {
+      sprintf (libslas_error.info, _("File : %s\nReturn number %d is out of range (1-5).\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, record->return_number,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_RETURN_NUMBER_OUT_OF_RANGE_ERROR);
+    }
+
+
+  /*  Increment the number of points by return.  */
+
+  LAS (hnd).header.number_of_points_by_return[record->return_number - 1]++;
+
+
+  /*  Pack the record and write it (or stage it in the I/O buffer).  */
+
+  libslas_pack_point_data (hnd, record, data);
+
+  if (libslas_write_point_buffer (hnd, data, LAS (hnd).header.point_data_record_length)) return (libslas_error.libslas);
+
+
+  LAS (hnd).modified = 1;
+  LAS (hnd).write = 1;
+  LAS (hnd).data = 1;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_read_raw_point_data
+
+ - Purpose:     Retrieve a range of consecutive LAS point data records exactly as they are stored
+                in the file.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the first LAS point data record to be
+                                      retrieved (records start at 0)
+                - count          =    The number of records to be retrieved
+                - data           =    The returned raw records.  This must be at least
+                                      count * point_data_record_length bytes.
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_READ_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                The records are packed, little endian, point_data_record_length byte LAS
+                records.  Nothing is unpacked, scaled, or swapped.  This is meant to be used
+                with libslas_append_raw_point_data to copy records from one LAS file to another
+                without any "creep".
+
+*********************************************************************************************/
+
+int32_t libslas_read_raw_point_data (int32_t hnd, int32_t recnum, int32_t count, uint8_t *data)
+{
+  /*  Check for records out of bounds.  */
+
+  if (recnum < 0 || count < 0 || (int64_t) recnum + (int64_t) count > (int64_t) LAS (hnd).header.number_of_point_records)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecords : %d through %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               recnum + count - 1, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  if (!count) return (LIBSLAS_SUCCESS);
+
+
+  /*  If the point data is memory mapped just copy it out of the map.  */
+
+  if (LAS (hnd).points != NULL)
+    {
+      memcpy (data, &LAS (hnd).points[(size_t) LAS (hnd).header.point_data_record_length * (size_t) recnum],
+              (size_t) LAS (hnd).header.point_data_record_length * (size_t) count);
+
+      return (LIBSLAS_SUCCESS);
+    }
+
+
+  return (libslas_read_point_block (hnd, recnum, count, data));
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_append_raw_point_data
+
+ - Purpose:     Append raw LAS point data records to a LAS file that is being created.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - count          =    The number of records to be appended
+                - data           =    The raw records (count * point_data_record_length bytes)
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_APPEND_ERROR
+                - LIBSLAS_RETURN_NUMBER_OUT_OF_RANGE_ERROR
+                - LIBSLAS_WRITE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                The records must be in this file's point data format with this file's
+                point_data_record_length (usually they came from libslas_read_raw_point_data on
+                a file with the same format).  They are written exactly as they are.  In order
+                for X, Y, and Z to mean the same thing in the new file the scale factors and
+                offsets in its header must match the file the records came from.  The header
+                mins, maxes, and point counts are computed from the raw integers.  If any record
+                has an invalid return number nothing is written.
+
+*********************************************************************************************/
+
+int32_t libslas_append_raw_point_data (int32_t hnd, int32_t count, uint8_t *data)
+{
+  int32_t          i, rec_length, num, bad;
+  RAW_POINT_STATS  stats;
+
+
+  /*  Appending a record is only allowed if you are creating a new file or it was opened LIBSLAS_APPEND.  */
+
+  if (!LAS (hnd).created && !LAS (hnd).append)
+    {
+      sprintf (libslas_error.info, _("File : %s\nAppending to pre-existing LAS file not allowed unless it is opened LIBSLAS_APPEND.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_APPEND_ERROR);
+    }
+
+
+  /*  Once the point count has been declared the records have to be written with libslas_write_point_data.  */
+
+  if (LAS (hnd).parallel)
+    {
+      sprintf (libslas_error.info, _("File : %s\nCan't append point records after declaring the point count.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_APPEND_ERROR);
+    }
+
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+
+
+  /*  Scan the records before we write anything.  */
+
+  memset (&stats, 0, sizeof (RAW_POINT_STATS));
+
+  if ((bad = libslas_scan_raw_point_data (hnd, data, count, &stats)) >= 0)
+    {
+      sprintf (libslas_error.info, _("File : %s\nReturn number %d is out of range (1-5) in raw record %d.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               data[(size_t) bad * (size_t) rec_length + 14] & 0x07, bad, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_RETURN_NUMBER_OUT_OF_RANGE_ERROR);
+    }
+
+
+  /*  Write the records (in pieces if there are more than 2GB of them).  */
+
+  for (i = 0 ; i < count ; i += num)
+    {
+      num = MIN (count - i, 0x7fffffff / rec_length);
+
+      if (libslas_write_point_buffer (hnd, &data[(size_t) i * (size_t) rec_length], num * rec_length)) return (libslas_error.libslas);
+    }
+
+
+  libslas_merge_raw_point_stats (hnd, &stats);
+
+
+  LAS (hnd).modified = 1;
+  LAS (hnd).write = 1;
+  LAS (hnd).data = 1;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_declare_point_count
+
+ - Purpose:     Declares the number of point data records that will be written to a LAS file
+                that is being created so that they can be written in any order (and by any
+                number of threads) using libslas_write_point_data.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - count          =    The number of point data records that will be written
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_POINT_COUNT_ERROR
+                - LIBSLAS_WRITE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                Call this after you have appended all of your VLRs and before you write any
+                point data.  Since we know where the point data starts and how long each record
+                is, we know where every record goes.  After this you can't use
+                libslas_append_point_data, libslas_append_raw_point_data, or
+                libslas_copy_point_data on the file.
+
+*********************************************************************************************/
+
+int32_t libslas_declare_point_count (int32_t hnd, int32_t count)
+{
+  if (!LAS (hnd).created || LAS (hnd).data || count < 0)
+    {
+      sprintf (libslas_error.info, _("File : %s\nThe point count can only be declared once, on a new file, before writing any point data.\nFunction: %s, Line: %d\n"),
+               LAS_COLD (hnd).path, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_POINT_COUNT_ERROR);
+    }
+
+
+  /*  Get the header and VLRs out of the stdio buffer before anyone starts writing point data around them.  */
+
+  if (fflush (LAS (hnd).fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing LAS header and VLRs :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_WRITE_ERROR);
+    }
+
+
+  /*  No VLRs, the point data starts right after the header.  */
+
+  if (!LAS (hnd).header.offset_to_point_data) LAS (hnd).header.offset_to_point_data = (uint32_t) LAS (hnd).pos;
+
+
+  memset (&LAS_COLD (hnd).stats, 0, sizeof (RAW_POINT_STATS));
+  LIBSLAS_STATS_INIT (hnd);
+
+  LAS (hnd).declared = count;
+  LAS (hnd).parallel = 1;
+  LAS (hnd).modified = 1;
+  LAS (hnd).data = 1;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_write_point_data
+
+ - Purpose:     Writes a range of consecutive LAS point data records at their final position in
+                a LAS file whose point count has been declared.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the first record to be written
+                                      (records start at 0)
+                - count          =    The number of records to be written
+                - records        =    The LIBSLAS_POINT_DATA structures to be written
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_POINT_COUNT_ERROR
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_RETURN_NUMBER_OUT_OF_RANGE_ERROR
+                - LIBSLAS_WRITE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                This function is thread safe.  Any number of threads can write records to the
+                same handle at the same time as long as they write different records.  Each
+                call packs the records and writes them with pwrite at the computed offset,
+                keeping its own mins, maxes, and counts by return.  Those are added to the
+                file's totals, under a lock, once per call, and the header is updated from the
+                totals when the file is closed.  So, call this with as many records at a time
+                as you can.
+
+                Every record from 0 to the declared count - 1 must be written exactly once.  If
+                the number of records written doesn't match the declared count,
+                libslas_close_las_file still writes the header (with the declared count) and
+                closes the file but returns LIBSLAS_POINT_COUNT_ERROR.  Records are checked for
+                valid return numbers before anything is written.
+
+                On Windows there is no pwrite so the writes themselves are done one at a time.
+
+*********************************************************************************************/
+
+int32_t libslas_write_point_data (int32_t hnd, int32_t recnum, int32_t count, LIBSLAS_POINT_DATA *records)
+{
+  int32_t          i, j, rec_length, block_count, num;
+  int64_t          addr;
+  uint8_t          block[POINT_BLOCK_SIZE];
+  RAW_POINT_STATS  stats;
+
+
+  if (!LAS (hnd).parallel)
+    {
+      sprintf (libslas_error.info, _("File : %s\nThe point count must be declared before using libslas_write_point_data.\nFunction: %s, Line: %d\n"),
+               LAS_COLD (hnd).path, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_POINT_COUNT_ERROR);
+    }
+
+
+  /*  Check for records out of bounds.  */
+
+  if (recnum < 0 || count < 0 || (int64_t) recnum + (int64_t) count > (int64_t) LAS (hnd).declared)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecords : %d through %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               recnum + count - 1, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  /*  Check the return numbers.  */
+
+  for (i = 0 ; i < count ; i++)
+    {
+      if (records[i].return_number < 1 || records[i].return_number > 5)
+        {
+          sprintf (libslas_error.info, _("File : %s\nReturn number %d is out of range (1-5) in record %d.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+                   records[i].return_number, recnum + i, __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_RETURN_NUMBER_OUT_OF_RANGE_ERROR);
+        }
+    }
+
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+  block_count = POINT_BLOCK_SIZE / rec_length;
+
+  memset (&stats, 0, sizeof (RAW_POINT_STATS));
+
+
+  /*  Pack and write a block at a time.  */
+
+  for (i = 0 ; i < count ; i += num)
+    {
+      num = MIN (block_count, count - i);
+
+      for (j = 0 ; j < num ; j++) libslas_pack_point_data (hnd, &records[i + j], &block[j * rec_length]);
+
+      libslas_scan_raw_point_data (hnd, block, num, &stats);
+
+
+      addr = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) rec_length * (int64_t) (recnum + i);
+
+#ifdef NVWIN3X
+      LIBSLAS_STATS_LOCK (hnd);
+      j = libslas_pwrite (hnd, addr, block, (size_t) rec_length * (size_t) num);
+      LIBSLAS_STATS_UNLOCK (hnd);
+#else
+      j = libslas_pwrite (hnd, addr, block, (size_t) rec_length * (size_t) num);
+#endif
+
+      if (j)
+        {
+          sprintf (libslas_error.info, _("File : %s\nError writing LAS records :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+                   __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_WRITE_ERROR);
+        }
+    }
+
+
+  LIBSLAS_STATS_LOCK (hnd);
+  libslas_add_raw_point_stats (&LAS_COLD (hnd).stats, &stats);
+  LIBSLAS_STATS_UNLOCK (hnd);
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_copy_point_data
+
+ - Purpose:     Copy a range of point data records from a LAS file to a LAS file that is being
+                created without passing the records through the application.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - src_hnd        =    The file handle of the file to copy from
+                - dst_hnd        =    The file handle of the file being created
+                - recnum         =    The record number of the first record to be copied
+                                      (records start at 0)
+                - count          =    The number of records to be copied
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_APPEND_ERROR
+                - LIBSLAS_INCOMPATIBLE_FILES_ERROR
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_RETURN_NUMBER_OUT_OF_RANGE_ERROR
+                - LIBSLAS_READ_ERROR
+                - LIBSLAS_WRITE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                Both files must have the same point data format, record length, scale factors,
+                and offsets.  On Linux the records are copied with copy_file_range (or sendfile)
+                so they never come into user space.  Anywhere else, or if the kernel refuses,
+                they are copied a block at a time.  The new file's header mins, maxes, and point
+                counts are computed by scanning the raw X, Y, Z, and return number values of the
+                source records (straight from the map if the source was opened with
+                LIBSLAS_READONLY_MMAP).
+
+*********************************************************************************************/
+
+int32_t libslas_copy_point_data (int32_t src_hnd, int32_t dst_hnd, int32_t recnum, int32_t count)
+{
+  int32_t          i, rec_length, block_count, num, bad;
+  int64_t          src_addr, dst_addr, done;
+  uint8_t          block[POINT_BLOCK_SIZE];
+  RAW_POINT_STATS  stats;
+
+
+  /*  Copying records is only allowed if you are creating the new file or it was opened LIBSLAS_APPEND.  */
+
+  if (!LAS (dst_hnd).created && !LAS (dst_hnd).append)
+    {
+      sprintf (libslas_error.info, _("File : %s\nAppending to pre-existing LAS file not allowed unless it is opened LIBSLAS_APPEND.\nFunction: %s, Line: %d\n"), LAS_COLD (dst_hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_APPEND_ERROR);
+    }
+
+
+  /*  Once the point count has been declared the records have to be written with libslas_write_point_data.  */
+
+  if (LAS (dst_hnd).parallel)
+    {
+      sprintf (libslas_error.info, _("File : %s\nCan't append point records after declaring the point count.\nFunction: %s, Line: %d\n"), LAS_COLD (dst_hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_APPEND_ERROR);
+    }
+
+
+  /*  The records have to mean the same thing in both files.  */
+
+  if (LAS (src_hnd).header.point_data_format_id != LAS (dst_hnd).header.point_data_format_id ||
+      LAS (src_hnd).header.point_data_record_length != LAS (dst_hnd).header.point_data_record_length ||
+      LAS (src_hnd).header.x_scale_factor != LAS (dst_hnd).header.x_scale_factor ||
+      LAS (src_hnd).header.y_scale_factor != LAS (dst_hnd).header.y_scale_factor ||
+      LAS (src_hnd).header.z_scale_factor != LAS (dst_hnd).header.z_scale_factor ||
+      LAS (src_hnd).header.x_offset != LAS (dst_hnd).header.x_offset ||
+      LAS (src_hnd).header.y_offset != LAS (dst_hnd).header.y_offset ||
+      LAS (src_hnd).header.z_offset != LAS (dst_hnd).header.z_offset)
+    {
+      sprintf (libslas_error.info, _("File : %.900s\nFile : %.900s\nPoint data format, record length, scale, or offset don't match.\nFunction: %s, Line: %d\n"),
+               LAS_COLD (src_hnd).path, LAS_COLD (dst_hnd).path, __FUNCTION__, __LINE__ - 10);
+      return (libslas_error.libslas = LIBSLAS_INCOMPATIBLE_FILES_ERROR);
+    }
+
+
+  /*  Check for records out of bounds.  */
+
+  if (recnum < 0 || count < 0 || (int64_t) recnum + (int64_t) count > (int64_t) LAS (src_hnd).header.number_of_point_records)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecords : %d through %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (src_hnd).path, recnum,
+               recnum + count - 1, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  if (!count) return (LIBSLAS_SUCCESS);
+
+
+  rec_length = LAS (src_hnd).header.point_data_record_length;
+  block_count = POINT_BLOCK_SIZE / rec_length;
+
+
+  /*  Scan the source records for the header statistics (and to make sure they're valid) before we write anything.  */
+
+  memset (&stats, 0, sizeof (RAW_POINT_STATS));
+
+  bad = -1;
+  if (LAS (src_hnd).points != NULL)
+    {
+      bad = libslas_scan_raw_point_data (src_hnd, &LAS (src_hnd).points[(size_t) rec_length * (size_t) recnum], count, &stats);
+    }
+  else
+    {
+      for (i = 0 ; i < count && bad < 0 ; i += num)
+        {
+          num = MIN (block_count, count - i);
+
+          if (libslas_read_point_block (src_hnd, recnum + i, num, block)) return (libslas_error.libslas);
+
+          if ((bad = libslas_scan_raw_point_data (src_hnd, block, num, &stats)) >= 0) bad += i;
+        }
+    }
+
+  if (bad >= 0)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nReturn number is out of range (1-5).\nFunction: %s, Line: %d\n"), LAS_COLD (src_hnd).path,
+               recnum + bad, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_RETURN_NUMBER_OUT_OF_RANGE_ERROR);
+    }
+
+
+  /*  Get everything that's been written to the new file out of the staging buffer and stdio (the header and VLRs) so
+      that we can write directly to the file descriptor.  The sendfile fallback moves the descriptor's file offset so we
+      can't leave anything for stdio to write later.  */
+
+  if (libslas_flush_point_buffer (dst_hnd, 0)) return (libslas_error.libslas);
+
+  fflush (LAS (dst_hnd).fp);
+
+  dst_addr = LAS (dst_hnd).pos;
+  src_addr = (int64_t) LAS (src_hnd).header.offset_to_point_data + (int64_t) rec_length * (int64_t) recnum;
+
+
+  /*  Let the kernel do as much of it as it can (in whole records).  */
+
+#ifdef NVWIN3X
+  done = 0;
+#else
+  done = libslas_kernel_copy (LAS (src_hnd).fd, src_addr, LAS (dst_hnd).fd, dst_addr, (int64_t) rec_length * (int64_t) count) / rec_length;
+#endif
+
+  LAS (dst_hnd).pos = dst_addr + done * rec_length;
+
+
+  /*  Copy whatever is left a block at a time.  */
+
+  for (i = (int32_t) done ; i < count ; i += num)
+    {
+      num = MIN (block_count, count - i);
+
+      if (libslas_read_point_block (src_hnd, recnum + i, num, block)) return (libslas_error.libslas);
+
+      if (libslas_write_point_buffer (dst_hnd, block, num * rec_length)) return (libslas_error.libslas);
+    }
+
+
+  libslas_merge_raw_point_stats (dst_hnd, &stats);
+
+
+  LAS (dst_hnd).modified = 1;
+  LAS (dst_hnd).write = 1;
+  LAS (dst_hnd).data = 1;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_update_point_data
+
+ - Purpose:     Updates the user modifiable fields of a LAS point data record without affecting
+                the "non-modifiable" fields.
+
+ - Author:      Jan C. Depner (area.based.editor@gmail.com)
+
+ - Date:        07/16/14
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the LAS point data record to be written
+		                      (records start at 0)
+                - record         =    The LIBSLAS_POINT_DATA structure to be updated
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_UPDATE_ERROR
+                - LIBSLAS_UPDATE_READ_ERROR
+                - LIBSLAS_NOT_OPEN_FOR_UPDATE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+*********************************************************************************************/
+
+int32_t libslas_update_point_data (int32_t hnd, int32_t recnum, LIBSLAS_POINT_DATA *record)
+{
+  int32_t   length;
+  uint8_t   data[POINT_DATA_SIZE];
+  int64_t   addr;
+
+
+  /*  Check for LIBSLAS_UPDATE mode.  */
+
+  if (LAS (hnd).mode != LIBSLAS_UPDATE)
+    {
+      sprintf (libslas_error.info, _("File : %s\nNot opened for update.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_NOT_OPEN_FOR_UPDATE_ERROR);
+    }
+
+
+  /*  Check for record out of bounds.  */
+
+  if (recnum >= LAS (hnd).header.number_of_point_records || recnum < 0)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  /*  Make sure any buffered point data has been written.  */
+
+  if (libslas_flush_point_buffer (hnd, 0)) return (libslas_error.libslas);
+
+
+  /*  Read the record (the modifiable fields are all in the first POINT_DATA_SIZE bytes).  */
+
+  addr = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) recnum;
+  length = MIN (LAS (hnd).header.point_data_record_length, POINT_DATA_SIZE);
+
+
+  if (libslas_pread (hnd, addr, data, length))
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nError reading LAS record :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_UPDATE_READ_ERROR);
+    }
+
+
+  /*  Modify the fields that can be changed (see libslas.h)  */
+
+  libslas_pack_modifiable_fields (hnd, record, data);
+
+
+  /*  Write the record.  */
+
+  if (libslas_pwrite (hnd, addr, data, length))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing LAS record :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_WRITE_ERROR);
+    }
+
+
+  LAS (hnd).modified = 1;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_update_point_data_fields
+
+ - Purpose:     Updates selected user modifiable fields of a LAS point data record by writing
+                only the bytes that hold those fields.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the LAS point data record to be written
+                                      (records start at 0)
+                - record         =    The LIBSLAS_POINT_DATA structure containing the new values
+                - fields         =    Bit mask of LIBSLAS_FIELD_* values (see libslas.h) specifying
+                                      which fields of record are to be written
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_UPDATE_READ_ERROR
+                - LIBSLAS_WRITE_ERROR
+                - LIBSLAS_NOT_OPEN_FOR_UPDATE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                Only the (m) fields of LIBSLAS_POINT_DATA can be updated.  Any other bits in
+                fields are ignored (so LIBSLAS_FIELD_ALL or LIBSLAS_FIELD_MODIFIABLE update
+                everything that libslas_update_point_data would).  The RGB bits are ignored
+                for point data formats 0 and 1.
+
+                The classification, synthetic, key_point, and withheld fields share one byte.
+                If all four of them are being set the byte is simply written, otherwise the
+                byte is read from the file first so the other bits are preserved.  No other
+                field requires a read.
+
+*********************************************************************************************/
+
+int32_t libslas_update_point_data_fields (int32_t hnd, int32_t recnum, LIBSLAS_POINT_DATA *record, uint32_t fields)
+{
+  int32_t   i, start, rgb;
+  uint16_t  psid, red, green, blue;
+  uint8_t   data[POINT_DATA_SIZE], dirty[POINT_DATA_SIZE], cls, old, mask;
+  int64_t   addr;
+
+
+  /*  Check for LIBSLAS_UPDATE mode.  */
+
+  if (LAS (hnd).mode != LIBSLAS_UPDATE)
+    {
+      sprintf (libslas_error.info, _("File : %s\nNot opened for update.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_NOT_OPEN_FOR_UPDATE_ERROR);
+    }
+
+
+  /*  Check for record out of bounds.  */
+
+  if (recnum >= LAS (hnd).header.number_of_point_records || recnum < 0)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  /*  Figure out where (and if) the RGB fields are stored.  */
+
+  switch (LAS (hnd).header.point_data_format_id)
+    {
+    case 2:
+      rgb = 20;
+      break;
+
+    case 3:
+      rgb = 28;
+      break;
+
+    default:
+      rgb = 0;
+      fields &= ~LIBSLAS_FIELD_RGB;
+      break;
+    }
+
+
+  fields &= LIBSLAS_FIELD_MODIFIABLE;
+
+  if (!fields) return (LIBSLAS_SUCCESS);
+
+
+  /*  Make sure any buffered point data has been written.  */
+
+  if (libslas_flush_point_buffer (hnd, 0)) return (libslas_error.libslas);
+
+
+  addr = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) recnum;
+
+  memset (dirty, 0, POINT_DATA_SIZE);
+
+
+  /*  Classification and flag bits (byte 15).  */
+
+  mask = 0;
+  if (fields & LIBSLAS_FIELD_CLASSIFICATION) mask |= 0x1f;
+  if (fields & LIBSLAS_FIELD_SYNTHETIC) mask |= 0x20;
+  if (fields & LIBSLAS_FIELD_KEY_POINT) mask |= 0x40;
+  if (fields & LIBSLAS_FIELD_WITHHELD) mask |= 0x80;
+
+  if (mask)
+    {
+      cls = 0;
+      cls |= record->classification;
+      cls |= (record->withheld << 7);
+      cls |= (record->key_point << 6);
+      cls |= (record->synthetic << 5);
+      cls &= mask;
+
+
+      /*  If we're not replacing the whole byte we have to read it to preserve the other bits.  */
+
+      if (mask != 0xff)
+        {
+          if (libslas_pread (hnd, addr + 15, &old, 1))
+            {
+              sprintf (libslas_error.info, _("File : %s\nRecord : %d\nError reading LAS record :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+                       strerror (errno), __FUNCTION__, __LINE__ - 3);
+              return (libslas_error.libslas = LIBSLAS_UPDATE_READ_ERROR);
+            }
+
+          cls |= (old & ~mask);
+        }
+
+      data[15] = cls;
+      dirty[15] = 1;
+    }
+
+
+  if (fields & LIBSLAS_FIELD_USER_DATA)
+    {
+      data[17] = record->user_data;
+      dirty[17] = 1;
+    }
+
+
+  if (fields & LIBSLAS_FIELD_POINT_SOURCE_ID)
+    {
+      psid = record->point_source_id;
+      if (LAS (hnd).swap) libslas_swap_uint16_t (&psid);
+      memcpy (&data[18], &psid, 2);
+      dirty[18] = dirty[19] = 1;
+    }
+
+
+  if (fields & LIBSLAS_FIELD_RED)
+    {
+      red = record->red;
+      if (LAS (hnd).swap) libslas_swap_uint16_t (&red);
+      memcpy (&data[rgb], &red, 2);
+      dirty[rgb] = dirty[rgb + 1] = 1;
+    }
+
+
+  if (fields & LIBSLAS_FIELD_GREEN)
+    {
+      green = record->green;
+      if (LAS (hnd).swap) libslas_swap_uint16_t (&green);
+      memcpy (&data[rgb + 2], &green, 2);
+      dirty[rgb + 2] = dirty[rgb + 3] = 1;
+    }
+
+
+  if (fields & LIBSLAS_FIELD_BLUE)
+    {
+      blue = record->blue;
+      if (LAS (hnd).swap) libslas_swap_uint16_t (&blue);
+      memcpy (&data[rgb + 4], &blue, 2);
+      dirty[rgb + 4] = dirty[rgb + 5] = 1;
+    }
+
+
+  /*  Write each contiguous run of changed bytes.  */
+
+  i = 15;
+  start = 0;
+  while (i < POINT_DATA_SIZE)
+    {
+      if (!dirty[i])
+        {
+          i++;
+          continue;
+        }
+
+      start = i;
+      while (i < POINT_DATA_SIZE && dirty[i]) i++;
+
+
+      if (libslas_pwrite (hnd, addr + start, &data[start], i - start))
+        {
+          sprintf (libslas_error.info, _("File : %s\nError writing LAS record :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+                   __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_WRITE_ERROR);
+        }
+    }
+
+
+  LAS (hnd).modified = 1;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_compare_point_update
+
+ - Purpose:     qsort comparison function used to sort LIBSLAS_POINT_UPDATE structures by
+                record number.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - a              =    Pointer to the first LIBSLAS_POINT_UPDATE structure
+                - b              =    Pointer to the second LIBSLAS_POINT_UPDATE structure
+
+ - Returns:
+                - -1, 0, or 1
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int libslas_compare_point_update (const void *a, const void *b)
+{
+  const LIBSLAS_POINT_UPDATE *pa = (const LIBSLAS_POINT_UPDATE *) a;
+  const LIBSLAS_POINT_UPDATE *pb = (const LIBSLAS_POINT_UPDATE *) b;
+
+  if (pa->recnum < pb->recnum) return (-1);
+  if (pa->recnum > pb->recnum) return (1);
+  return (0);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_update_point_data_batch
+
+ - Purpose:     Updates the user modifiable fields of a set of (possibly scattered) LAS point
+                data records without affecting the "non-modifiable" fields.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - count          =    The number of entries in the updates array
+                - updates        =    Array of LIBSLAS_POINT_UPDATE structures containing the
+                                      record numbers and new values of the records to be updated
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_UPDATE_READ_ERROR
+                - LIBSLAS_WRITE_ERROR
+                - LIBSLAS_NOT_OPEN_FOR_UPDATE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  Success or a file handle
+                will be greater than or equal to zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                The updates array is sorted in place by record number.  Updates whose records
+                fall within POINT_BLOCK_SIZE bytes of the first record in a run are coalesced
+                into a single read-modify-write of the whole run, so each run costs one read
+                and one write no matter how many records in it are being changed.  The
+                unchanged records between the updated ones are written back exactly as they
+                were read.  As many runs as will fit in POINT_BLOCK_SIZE bytes are read (and
+                then written) as one batch so, if the file is using the LIBSLAS_IO_URING I/O
+                engine (see libslas_set_io_engine), a burst of scattered updates costs a
+                couple of system calls per batch instead of two per record.
+
+                If the same record number appears more than once in the array it is undefined
+                which of the updates ends up in the file.
+
+                All of the record numbers are checked before anything is written so an invalid
+                record number will not leave the file partially updated.  An I/O error part
+                way through will.
+
+*********************************************************************************************/
+
+int32_t libslas_update_point_data_batch (int32_t hnd, int32_t count, LIBSLAS_POINT_UPDATE *updates)
+{
+  int32_t     i, j, k, m, rec_length, block_count, first, num, used, runs, start, end[IO_BATCH_SIZE];
+  uint8_t     block[POINT_BLOCK_SIZE];
+  IO_REQUEST  req[IO_BATCH_SIZE];
+
+
+  /*  Check for LIBSLAS_UPDATE mode.  */
+
+  if (LAS (hnd).mode != LIBSLAS_UPDATE)
+    {
+      sprintf (libslas_error.info, _("File : %s\nNot opened for update.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_NOT_OPEN_FOR_UPDATE_ERROR);
+    }
+
+
+  /*  Check for records out of bounds.  */
+
+  for (i = 0 ; i < count ; i++)
+    {
+      if (updates[i].recnum >= LAS (hnd).header.number_of_point_records || updates[i].recnum < 0)
+        {
+          sprintf (libslas_error.info, _("File : %s\nRecord : %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+                   updates[i].recnum, __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+        }
+    }
+
+
+  if (count <= 0) return (LIBSLAS_SUCCESS);
+
+
+  /*  Make sure any buffered point data has been written.  */
+
+  if (libslas_flush_point_buffer (hnd, 0)) return (libslas_error.libslas);
+
+
+  /*  Sort the updates by record number (and thus by address in the file).  */
+
+  qsort (updates, count, sizeof (LIBSLAS_POINT_UPDATE), libslas_compare_point_update);
+
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+  block_count = POINT_BLOCK_SIZE / rec_length;
+
+
+  for (i = 0 ; i < count ; )
+    {
+      /*  Gather as many runs as will fit in the block.  A run is all of the updates that fit in a block starting at its first
+          record so the first run always fits.  */
+
+      start = i;
+      used = runs = 0;
+
+      while (i < count && runs < IO_BATCH_SIZE)
+        {
+          first = updates[i].recnum;
+          for (j = i + 1 ; j < count && updates[j].recnum - first < block_count ; j++);
+          num = updates[j - 1].recnum - first + 1;
+
+          if (used + rec_length * num > POINT_BLOCK_SIZE) break;
+
+          req[runs].addr = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) rec_length * (int64_t) first;
+          req[runs].buffer = &block[used];
+          req[runs].length = (size_t) rec_length * (size_t) num;
+          end[runs] = j;
+
+          used += rec_length * num;
+          runs++;
+          i = j;
+        }
+
+
+      if (libslas_batch_io (hnd, req, runs, 0))
+        {
+          sprintf (libslas_error.info, _("File : %s\nRecords : %d through %d\nError reading LAS records :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+                   updates[start].recnum, updates[i - 1].recnum, strerror (errno), __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_UPDATE_READ_ERROR);
+        }
+
+
+      /*  Modify the fields that can be changed (see libslas.h)  */
+
+      for (k = 0, m = start ; k < runs ; k++)
+        {
+          first = updates[m].recnum;
+          for ( ; m < end[k] ; m++) libslas_pack_modifiable_fields (hnd, &updates[m].record, &req[k].buffer[(updates[m].recnum - first) * rec_length]);
+        }
+
+
+      if (libslas_batch_io (hnd, req, runs, 1))
+        {
+          sprintf (libslas_error.info, _("File : %s\nError writing LAS records :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+                   __FUNCTION__, __LINE__ - 3);
+          return (libslas_error.libslas = LIBSLAS_WRITE_ERROR);
+        }
+    }
+
+
+  LAS (hnd).modified = 1;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_set_io_buffer
+
+ - Purpose:     Supplies an I/O buffer to be used for staging point data records appended to a
+                LAS file that is being created.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - buffer         =    The application allocated buffer or NULL to go back to
+                                      unbuffered point data writes
+                - size           =    Size of the buffer in bytes (at least
+                                      LIBSLAS_MIN_IO_BUFFER_SIZE)
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_BUFFER_ERROR
+                - LIBSLAS_WRITE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                Keeping with the no memory allocation in the API rule, the application owns the
+                buffer.  It must not be freed (or used for anything else) until the file has
+                been closed or libslas_set_io_buffer has been called again with a NULL buffer.
+                A few megabytes is plenty.  Point records are packed into the buffer and, when
+                it fills up, written with a single write that ends on a 4096 byte boundary in
+                the file.  The buffer is flushed when the file is closed or when you read or
+                update a point record.
+
+*********************************************************************************************/
+
+int32_t libslas_set_io_buffer (int32_t hnd, uint8_t *buffer, int32_t size)
+{
+  if (buffer != NULL && size < LIBSLAS_MIN_IO_BUFFER_SIZE)
+    {
+      sprintf (libslas_error.info, _("File : %s\nI/O buffer size %d is too small (minimum %d).\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, size,
+               LIBSLAS_MIN_IO_BUFFER_SIZE, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_BUFFER_ERROR);
+    }
+
+
+  /*  Get rid of anything that's waiting in the old buffer.  */
+
+  if (libslas_flush_point_buffer (hnd, 0)) return (libslas_error.libslas);
+
+
+  LAS (hnd).buffer = buffer;
+  LAS (hnd).buffer_size = buffer == NULL ? 0 : size;
+  LAS (hnd).buffer_used = 0;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_set_read_ahead
+
+ - Purpose:     Supplies a buffer to be used to read point data records ahead of the
+                application on a LAS file that was opened LIBSLAS_READONLY (or
+                LIBSLAS_READONLY_DIRECT).  A background thread keeps up to three large
+                blocks of records, following the last record read, loaded so that the
+                application can be unpacking one block while the next ones are being read.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - buffer         =    The application allocated buffer or NULL to stop
+                                      reading ahead
+                - size           =    Size of the buffer in bytes (at least
+                                      LIBSLAS_MIN_IO_BUFFER_SIZE)
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_BUFFER_ERROR
+                - LIBSLAS_READ_AHEAD_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                Keeping with the no memory allocation in the API rule, the application owns the
+                buffer.  It must not be freed (or used for anything else) until the file has
+                been closed or libslas_set_read_ahead has been called again with a NULL buffer.
+                The buffer is split into three slots.  A few megabytes per slot is about right
+                for a spinning disk or a network file system, less will do for an SSD.
+
+                Read ahead only helps when the records are read more or less sequentially
+                (libslas_read_point_data, libslas_read_point_data_range,
+                libslas_read_point_columns, libslas_read_point_data_fields, or
+                libslas_read_raw_point_data).  If the application jumps to a record that isn't
+                in (or just past) the read-ahead buffer, that read goes straight to the file
+                and reading ahead starts over after it.  A handle that is being read ahead
+                must only be read by one thread at a time.
+
+                Reading ahead isn't available on Windows or for LIBSLAS_READONLY_MMAP files (which
+                the OS already reads ahead for us).
+
+*********************************************************************************************/
+
+int32_t libslas_set_read_ahead (int32_t hnd, uint8_t *buffer, int32_t size)
+{
+#ifndef NO_READ_AHEAD
+  int32_t            i, slot_records;
+  READ_AHEAD_STRUCT  *ra;
+#endif
+
+
+  /*  Stop the old read-ahead thread (if any).  */
+
+  libslas_stop_read_ahead (hnd);
+
+  if (buffer == NULL) return (LIBSLAS_SUCCESS);
+
+
+#ifdef NO_READ_AHEAD
+
+  sprintf (libslas_error.info, _("File : %s\nRead ahead is not available on this system.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, __FUNCTION__,
+           __LINE__ - 1);
+  return (libslas_error.libslas = LIBSLAS_READ_AHEAD_ERROR);
+
+#else
+
+  if (LAS (hnd).mode != LIBSLAS_READONLY && LAS (hnd).mode != LIBSLAS_READONLY_DIRECT)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRead ahead is only available for files opened LIBSLAS_READONLY or LIBSLAS_READONLY_DIRECT.\nFunction: %s, Line: %d\n"),
+               LAS_COLD (hnd).path, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_READ_AHEAD_ERROR);
+    }
+
+
+  slot_records = size / READ_AHEAD_SLOTS / LAS (hnd).header.point_data_record_length;
+
+  if (size < LIBSLAS_MIN_IO_BUFFER_SIZE || slot_records < 1)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRead ahead buffer size %d is too small (minimum %d).\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, size,
+               LIBSLAS_MIN_IO_BUFFER_SIZE, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_BUFFER_ERROR);
+    }
+
+
+  ra = &LAS_COLD (hnd).read_ahead;
+
+  memset (ra, 0, sizeof (READ_AHEAD_STRUCT));
+
+  for (i = 0 ; i < READ_AHEAD_SLOTS ; i++)
+    {
+      ra->slot[i] = buffer + (size_t) i * (size_t) slot_records * (size_t) LAS (hnd).header.point_data_record_length;
+      ra->state[i] = SLOT_EMPTY;
+    }
+
+  ra->slot_records = slot_records;
+
+
+  pthread_mutex_init (&ra->mutex, NULL);
+  pthread_cond_init (&ra->cond, NULL);
+
+  if (pthread_create (&ra->thread, NULL, libslas_read_ahead_thread, (void *) (size_t) hnd))
+    {
+      pthread_cond_destroy (&ra->cond);
+      pthread_mutex_destroy (&ra->mutex);
+
+      sprintf (libslas_error.info, _("File : %s\nUnable to start read ahead thread :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, strerror (errno),
+               __FUNCTION__, __LINE__ - 5);
+      return (libslas_error.libslas = LIBSLAS_READ_AHEAD_ERROR);
+    }
+
+  LAS (hnd).ra = ra;
+
+
+  return (LIBSLAS_SUCCESS);
+
+#endif
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_set_io_engine
+
+ - Purpose:     Selects the I/O engine used for batches of point data reads and writes
+                (libslas_read_point_data_batch and libslas_update_point_data_batch).
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - engine         =    LIBSLAS_IO_DEFAULT or LIBSLAS_IO_URING
+
+ - Returns:
+                - LIBSLAS_IO_DEFAULT or LIBSLAS_IO_URING, whichever is actually being used
+                - LIBSLAS_IO_ENGINE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                LIBSLAS_IO_DEFAULT does one pread or pwrite system call per record (or run of
+                nearby records).  LIBSLAS_IO_URING sets up a Linux io_uring for the file and
+                hands the kernel a whole batch of reads or writes with a single system call.
+                If the system can't do io_uring (not Linux, a kernel older than 5.6, or
+                io_uring disabled by the administrator or a container's seccomp filter) you
+                get LIBSLAS_IO_DEFAULT back and everything works the way it always did.  This
+                isn't an error so check the return value if you care which one you got.
+
+                The io_uring is shared by all threads using the handle (they take turns) and
+                is torn down when the file is closed.
+
+*********************************************************************************************/
+
+int32_t libslas_set_io_engine (int32_t hnd, int32_t engine)
+{
+  if (engine != LIBSLAS_IO_DEFAULT && engine != LIBSLAS_IO_URING)
+    {
+      sprintf (libslas_error.info, _("File : %s\nInvalid I/O engine %d.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, engine, __FUNCTION__,
+               __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_IO_ENGINE_ERROR);
+    }
+
+
+  if (LAS (hnd).uring != NULL)
+    {
+#ifndef NO_IO_URING
+      if (engine == LIBSLAS_IO_URING && LAS_COLD (hnd).uring.fd > 0) return (LIBSLAS_IO_URING);
+#endif
+
+      libslas_stop_io_uring (hnd);
+    }
+
+
+#ifndef NO_IO_URING
+  if (engine == LIBSLAS_IO_URING && !libslas_start_io_uring (hnd)) return (LIBSLAS_IO_URING);
+#endif
+
+
+  return (LIBSLAS_IO_DEFAULT);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_advise
+
+ - Purpose:     Tells the API (and the operating system) how the application is going to
+                access a range of point data records.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - recnum         =    The record number of the first record in the range
+                - count          =    The number of records in the range (0 means through the
+                                      end of the file)
+                - pattern        =    LIBSLAS_ADVISE_NORMAL, LIBSLAS_ADVISE_SEQUENTIAL,
+                                      LIBSLAS_ADVISE_RANDOM, LIBSLAS_ADVISE_WILLNEED, or
+                                      LIBSLAS_ADVISE_DONTNEED
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
+                - LIBSLAS_INVALID_ADVICE_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                The record range is converted to the byte range it occupies in the file and
+                handed to posix_fadvise (or madvise for a LIBSLAS_READONLY_MMAP file).  This is
+                only advice, if the system doesn't support it (or ignores it) that's not an
+                error.  On Linux LIBSLAS_ADVISE_SEQUENTIAL doubles the kernel's read-ahead
+                window, LIBSLAS_ADVISE_RANDOM turns it off, LIBSLAS_ADVISE_WILLNEED starts
+                reading the range into the page cache in the background, and
+                LIBSLAS_ADVISE_DONTNEED drops it from the page cache (handy after a one pass
+                scan of a file that wasn't opened LIBSLAS_READONLY_DIRECT).
+
+                The API doesn't allocate any buffers of its own so the only buffer it can size
+                for you is the read-ahead window of a handle that is using
+                libslas_set_read_ahead.  On such a handle LIBSLAS_ADVISE_RANDOM stops reading
+                ahead (so random reads don't drag a few megabytes of useless records in behind
+                every one) and LIBSLAS_ADVISE_NORMAL, LIBSLAS_ADVISE_SEQUENTIAL, and
+                LIBSLAS_ADVISE_WILLNEED start reading ahead at recnum right away.
+
+*********************************************************************************************/
+
+int32_t libslas_advise (int32_t hnd, int32_t recnum, int32_t count, int32_t pattern)
+{
+#ifndef NVWIN3X
+  int64_t  start, length, page_size, map_start;
+#endif
+
+
+  if (pattern < LIBSLAS_ADVISE_NORMAL || pattern > LIBSLAS_ADVISE_DONTNEED)
+    {
+      sprintf (libslas_error.info, _("File : %s\nInvalid access pattern %d.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, pattern, __FUNCTION__,
+               __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_ADVICE_ERROR);
+    }
+
+
+  /*  Check for records out of bounds.  */
+
+  if (!count) count = (int32_t) LAS (hnd).header.number_of_point_records - recnum;
+
+  if (recnum < 0 || count < 0 || (int64_t) recnum + (int64_t) count > (int64_t) LAS (hnd).header.number_of_point_records)
+    {
+      sprintf (libslas_error.info, _("File : %s\nRecords : %d through %d\nInvalid record number.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path, recnum,
+               recnum + count - 1, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+    }
+
+
+  /*  Tell the read-ahead thread (if there is one).  */
+
+  if (LAS (hnd).ra != NULL)
+    {
+      switch (pattern)
+        {
+        case LIBSLAS_ADVISE_NORMAL:
+        case LIBSLAS_ADVISE_SEQUENTIAL:
+        case LIBSLAS_ADVISE_WILLNEED:
+          libslas_restart_read_ahead (hnd, recnum, 0);
+          break;
+
+        case LIBSLAS_ADVISE_RANDOM:
+          libslas_restart_read_ahead (hnd, recnum, 1);
+          break;
+        }
+    }
+
+
+#ifndef NVWIN3X
+
+  if (!count) return (LIBSLAS_SUCCESS);
+
+
+  start = (int64_t) LAS (hnd).header.offset_to_point_data + (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) recnum;
+  length = (int64_t) LAS (hnd).header.point_data_record_length * (int64_t) count;
+
+
+  /*  Memory mapped, madvise the pages of the map that hold the records.  */
+
+  if (LAS_COLD (hnd).map != NULL)
+    {
+#ifdef MADV_NORMAL
+      static int32_t madvice[5] = {MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED, MADV_DONTNEED};
+
+      page_size = (int64_t) sysconf (_SC_PAGESIZE);
+
+
+      /*  File address of the start of the map.  */
+
+      map_start = (int64_t) LAS (hnd).header.offset_to_point_data - (int64_t) (LAS (hnd).points - LAS_COLD (hnd).map);
+
+      length += (start - map_start) % page_size;
+      start = ((start - map_start) / page_size) * page_size;
+
+      madvise (LAS_COLD (hnd).map + start, (size_t) length, madvice[pattern]);
+#endif
+    }
+  else
+    {
+#ifdef __linux__
+      static int32_t fadvice[5] = {POSIX_FADV_NORMAL, POSIX_FADV_SEQUENTIAL, POSIX_FADV_RANDOM, POSIX_FADV_WILLNEED, POSIX_FADV_DONTNEED};
+
+      posix_fadvise64 (LAS (hnd).fd, (off64_t) start, (off64_t) length, fadvice[pattern]);
+#endif
+    }
+
+#endif
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+#ifndef NO_PARALLEL_SCAN
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_scan_thread
+
+ - Purpose:     Worker thread for libslas_parallel_scan.  Grabs the next batch of records,
+                reads and decodes it, and hands it to the application's callback until there
+                aren't any more (or somebody says stop).
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - arg            =    The SCAN_WORKER structure for this thread
+
+ - Returns:
+                - NULL
+
+ - Caveats:     Error information is per thread so the first error any worker runs into is
+                copied into the shared SCAN_STRUCT for libslas_parallel_scan to pass back.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void *libslas_scan_thread (void *arg)
+{
+  SCAN_WORKER         *worker;
+  SCAN_STRUCT         *scan;
+  LIBSLAS_POINT_DATA  records[SCAN_BATCH_SIZE];
+  int32_t             recnum, count;
+
+
+  worker = (SCAN_WORKER *) arg;
+  scan = worker->scan;
+
+
+  while (1)
+    {
+      /*  Get the next batch.  */
+
+      pthread_mutex_lock (&scan->mutex);
+
+      if (scan->stop || scan->next >= scan->num_recs)
+        {
+          pthread_mutex_unlock (&scan->mutex);
+          break;
+        }
+
+      recnum = scan->next;
+      count = MIN (SCAN_BATCH_SIZE, scan->num_recs - recnum);
+      scan->next += count;
+
+      pthread_mutex_unlock (&scan->mutex);
+
+
+      if (libslas_read_point_data_range (scan->hnd, recnum, count, records))
+        {
+          pthread_mutex_lock (&scan->mutex);
+
+          if (!scan->stop) scan->error = libslas_error;
+          scan->stop = 1;
+
+          pthread_mutex_unlock (&scan->mutex);
+          break;
+        }
+
+
+      if ((*scan->callback) (worker->thread, recnum, count, records, scan->user_ctx))
+        {
+          pthread_mutex_lock (&scan->mutex);
+          scan->stop = 1;
+          pthread_mutex_unlock (&scan->mutex);
+          break;
+        }
+    }
+
+
+  return (NULL);
+}
+
+#endif
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_parallel_scan
+
+ - Purpose:     Reads every point data record in a LAS file, in batches of consecutive
+                records, using a pool of worker threads.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - path           =    Path name
+                - nthreads       =    Number of worker threads (0 or less to use one per
+                                      online processor, at most 256)
+                - callback       =    Function that will be called with each batch of
+                                      records (see LIBSLAS_SCAN_CALLBACK in libslas.h)
+                - user_ctx       =    Anything you want passed to the callback
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - Error value from libslas_open_las_file
+                - LIBSLAS_READ_ERROR
+                - LIBSLAS_THREAD_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                The file is opened once (LIBSLAS_READONLY) and all of the workers read through
+                that handle with pread so there's no per thread open and no seeking.  Batches
+                of 4096 consecutive records are handed out in file order to whichever worker
+                is free next, so the disk sees a (mostly) sequential scan and a slow callback
+                in one thread doesn't hold up the others.  Batches are not delivered in order,
+                the callback gets the record number of the first record in the batch, and the
+                worker number (0 to nthreads - 1) so that you can keep per thread results
+                without locking.
+
+                The callback is called from the worker threads, so it has to be thread safe.
+                The records array belongs to the worker and is only good until the callback
+                returns.  If the callback returns anything but 0 the scan stops as soon as
+                the other workers finish the batches they're working on and
+                libslas_parallel_scan returns LIBSLAS_SUCCESS (stopping isn't an error).
+
+                The worker threads' stacks are a little over 1MB each (the decoded batch lives
+                there), so nothing is allocated on the heap.  On Windows there's no pread so
+                the batches are all read and handed to the callback (as worker 0) in the
+                calling thread.
+
+*********************************************************************************************/
+
+int32_t libslas_parallel_scan (char *path, int32_t nthreads, LIBSLAS_SCAN_CALLBACK callback, void *user_ctx)
+{
+  LIBSLAS_HEADER       header;
+  int32_t              hnd;
+#ifndef NO_PARALLEL_SCAN
+  int32_t              i, started, batches, status;
+  pthread_t            thread[SCAN_MAX_THREADS];
+  pthread_attr_t       attr;
+  SCAN_WORKER          worker[SCAN_MAX_THREADS];
+  SCAN_STRUCT          scan;
+#else
+  int32_t              recnum, count;
+  LIBSLAS_POINT_DATA   records[SCAN_BATCH_SIZE];
+#endif
+
+
+  if ((hnd = libslas_open_las_file (path, &header, LIBSLAS_READONLY)) < 0) return (hnd);
+
+
+  /*  We're going to read the whole thing, front to back (more or less).  */
+
+  libslas_advise (hnd, 0, 0, LIBSLAS_ADVISE_SEQUENTIAL);
+
+
+#ifdef NO_PARALLEL_SCAN
+
+  for (recnum = 0 ; recnum < (int32_t) header.number_of_point_records ; recnum += count)
+    {
+      count = MIN (SCAN_BATCH_SIZE, (int32_t) header.number_of_point_records - recnum);
+
+      if (libslas_read_point_data_range (hnd, recnum, count, records))
+        {
+          libslas_close_las_file (hnd);
+          return (libslas_error.libslas);
+        }
+
+      if ((*callback) (0, recnum, count, records, user_ctx)) break;
+    }
+
+#else
+
+  if (nthreads <= 0) nthreads = (int32_t) sysconf (_SC_NPROCESSORS_ONLN);
+
+
+  /*  No point in starting more threads than there are batches.  */
+
+  batches = ((int32_t) header.number_of_point_records + SCAN_BATCH_SIZE - 1) / SCAN_BATCH_SIZE;
+
+  nthreads = MAX (1, MIN (nthreads, MIN (batches, SCAN_MAX_THREADS)));
+
+
+  memset (&scan, 0, sizeof (SCAN_STRUCT));
+
+  scan.hnd = hnd;
+  scan.num_recs = (int32_t) header.number_of_point_records;
+  scan.callback = callback;
+  scan.user_ctx = user_ctx;
+
+  pthread_mutex_init (&scan.mutex, NULL);
+
+
+  pthread_attr_init (&attr);
+  pthread_attr_setstacksize (&attr, SCAN_STACK_SIZE);
+
+  for (started = 0 ; started < nthreads ; started++)
+    {
+      worker[started].scan = &scan;
+      worker[started].thread = started;
+
+      /*  If we couldn't start any threads at all, give up.  If we got some of them we'll just run with those.  */
+
+      if ((status = pthread_create (&thread[started], &attr, libslas_scan_thread, &worker[started])) != 0)
+        {
+          if (!started)
+            {
+              sprintf (libslas_error.info, _("File : %s\nUnable to start parallel scan threads :\n%s\nFunction: %s, Line: %d\n"), path, strerror (status),
+                       __FUNCTION__, __LINE__ - 5);
+
+              pthread_attr_destroy (&attr);
+              pthread_mutex_destroy (&scan.mutex);
+              libslas_close_las_file (hnd);
+
+              return (libslas_error.libslas = LIBSLAS_THREAD_ERROR);
+            }
+
+          break;
+        }
+    }
+
+  pthread_attr_destroy (&attr);
+
+
+  for (i = 0 ; i < started ; i++) pthread_join (thread[i], NULL);
+
+  pthread_mutex_destroy (&scan.mutex);
+
+
+  if (scan.error.libslas)
+    {
+      libslas_close_las_file (hnd);
+      libslas_error = scan.error;
+      return (libslas_error.libslas);
+    }
+
+#endif
+
+
+  if (libslas_close_las_file (hnd)) return (libslas_error.libslas);
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_index_path
+
+ - Purpose:     Builds the name of a sidecar file (spatial index or zone map) for a LAS file.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - path           =    The returned sidecar file name
+                - ext            =    The sidecar file extension (".lsi" or ".lsz")
+
+ - Returns:
+                - void
+
+ - Caveats:     The sidecar file has the same name as the LAS file with ext instead of .las
+                (we don't open anything that doesn't end in .las).
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static void libslas_index_path (int32_t hnd, char *path, char *ext)
+{
+  strcpy (path, LAS_COLD (hnd).path);
+  strcpy (&path[strlen (path) - 4], ext);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_get_file_stamp
+
+ - Purpose:     Gets the size and modification time of a LAS file.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - stamp          =    The returned size and modification time
+
+ - Returns:
+                - 0 on success
+                - -1 if fstat failed (errno is set)
+
+ - Caveats:     The sidecar files (spatial index and zone map) save this when they're built and
+                won't be used if it changes.  That catches a file that was rewritten or
+                re-sorted by another program without changing the point count or the bounds.
+                Anything we've written through stdio is flushed first so the size is right.
+                The modification time only moves as often as the kernel's file time clock
+                ticks (a few milliseconds on Linux, a second on Windows), so a same-size write
+                made within one tick of building a sidecar may not be seen.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_get_file_stamp (int32_t hnd, FILE_STAMP *stamp)
+{
+#ifdef NVWIN3X
+  struct _stat64  st;
+#else
+  struct stat64   st;
+#endif
+
+
+  memset (stamp, 0, sizeof (FILE_STAMP));
+
+  if (LAS (hnd).write) fflush (LAS (hnd).fp);
+
+#ifdef NVWIN3X
+  if (_fstat64 (_fileno (LAS (hnd).fp), &st) < 0) return (-1);
+#else
+  if (fstat64 (fileno (LAS (hnd).fp), &st) < 0) return (-1);
+#endif
+
+  stamp->size = (int64_t) st.st_size;
+
+#if defined (NVWIN3X)
+  stamp->mtime_sec = (int64_t) st.st_mtime;
+#elif defined (__APPLE__)
+  stamp->mtime_sec = (int64_t) st.st_mtimespec.tv_sec;
+  stamp->mtime_nsec = (int64_t) st.st_mtimespec.tv_nsec;
+#else
+  stamp->mtime_sec = (int64_t) st.st_mtim.tv_sec;
+  stamp->mtime_nsec = (int64_t) st.st_mtim.tv_nsec;
+#endif
+
+
+  return (0);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_compare_runs
+
+ - Purpose:     qsort comparison function for record runs (pairs of first record and count).
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - a              =    Pointer to the first run
+                - b              =    Pointer to the second run
+
+ - Returns:
+                - Less than, equal to, or greater than zero
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int libslas_compare_runs (const void *a, const void *b)
+{
+  int32_t first_a = *((const int32_t *) a), first_b = *((const int32_t *) b);
+
+  return ((first_a > first_b) - (first_a < first_b));
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_find_index_runs
+
+ - Purpose:     Finds the runs of consecutive point data records that fall in each cell of
+                the spatial index grid.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - hdr            =    The spatial index header (with the grid laid out)
+                - cur            =    Scratch, one per cell
+                - count          =    Returned number of runs in each cell (zeroed, one per
+                                      cell plus one, the count for cell N goes in N + 1)
+                - runs           =    Returned runs in record order (allocated here, the
+                                      caller has to free it even if we fail)
+                - nruns          =    Returned number of runs
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+                - Error value from libslas_read_raw_point_data
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_find_index_runs (int32_t hnd, INDEX_HEADER *hdr, int64_t *cur, int64_t *count, INDEX_RUN **runs, int64_t *nruns)
+{
+  int32_t    i, j, num, rec_length, block_count, cell, ix, iy, raw_x, raw_y;
+  int64_t    max_runs = 0;
+  double     x, y;
+  uint8_t    block[POINT_BLOCK_SIZE];
+  INDEX_RUN  *new_runs;
+
+
+  for (i = 0 ; i < hdr->nx * hdr->ny ; i++) cur[i] = -1;
+
+  *runs = NULL;
+  *nruns = 0;
+
+
+  /*  Read a block at a time.  All of the point formats start with the raw X and Y.  */
+
+  rec_length = LAS (hnd).header.point_data_record_length;
+  block_count = POINT_BLOCK_SIZE / rec_length;
+
+  for (i = 0 ; i < (int32_t) hdr->number_of_point_records ; i += num)
+    {
+      num = MIN (block_count, (int32_t) hdr->number_of_point_records - i);
+
+      if (libslas_read_raw_point_data (hnd, i, num, block)) return (libslas_error.libslas);
+
+      for (j = 0 ; j < num ; j++)
+        {
+          memcpy (&raw_x, &block[j * rec_length], 4);
+          memcpy (&raw_y, &block[j * rec_length + 4], 4);
+
+          if (LAS (hnd).swap)
+            {
+              libslas_swap_uint32_t ((uint32_t *) &raw_x);
+              libslas_swap_uint32_t ((uint32_t *) &raw_y);
+            }
+
+          x = (double) raw_x * LAS (hnd).header.x_scale_factor + LAS (hnd).header.x_offset;
+          y = (double) raw_y * LAS (hnd).header.y_scale_factor + LAS (hnd).header.y_offset;
+
+          ix = MIN (MAX ((int32_t) ((x - hdr->min_x) / hdr->cell_x), 0), hdr->nx - 1);
+          iy = MIN (MAX ((int32_t) ((y - hdr->min_y) / hdr->cell_y), 0), hdr->ny - 1);
+          cell = iy * hdr->nx + ix;
+
+
+          /*  Either this record continues the cell's current run or it starts a new one.  */
+
+          if (cur[cell] >= 0 && (*runs)[cur[cell]].first + (*runs)[cur[cell]].count == i + j)
+            {
+              (*runs)[cur[cell]].count++;
+            }
+          else
+            {
+              if (*nruns == max_runs)
+                {
+                  max_runs = max_runs ? max_runs * 2 : 65536;
+
+                  if ((new_runs = (INDEX_RUN *) realloc (*runs, (size_t) max_runs * sizeof (INDEX_RUN))) == NULL)
+                    {
+                      sprintf (libslas_error.info, _("File : %s\nUnable to allocate memory for the spatial index :\n%s\nFunction: %s, Line: %d\n"),
+                               LAS_COLD (hnd).path, strerror (errno), __FUNCTION__, __LINE__ - 3);
+                      return (libslas_error.libslas = LIBSLAS_MEMORY_ALLOCATION_ERROR);
+                    }
+
+                  *runs = new_runs;
+                }
+
+              (*runs)[*nruns].cell = cell;
+              (*runs)[*nruns].first = i + j;
+              (*runs)[*nruns].count = 1;
+              cur[cell] = (*nruns)++;
+              count[cell + 1]++;
+            }
+        }
+    }
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_write_spatial_index
+
+ - Purpose:     Sorts the spatial index runs by cell and writes the spatial index sidecar
+                file.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - hdr            =    The spatial index header
+                - cur            =    Scratch, one per cell
+                - offset         =    Number of runs in each cell (see
+                                      libslas_find_index_runs), returned as the index of the
+                                      first run of each cell
+                - runs           =    Runs in record order
+                - nruns          =    Number of runs
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+                - LIBSLAS_INDEX_ERROR
+
+ - Caveats:     This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
+
+static int32_t libslas_write_spatial_index (int32_t hnd, INDEX_HEADER *hdr, int64_t *cur, int64_t *offset, INDEX_RUN *runs, int64_t nruns)
+{
+  int32_t  i, *list = NULL;
+  int64_t  k;
+  char     path[1024];
+  FILE     *fp;
+
+
+  /*  Sort the runs by cell (they're already in record order within each cell).  */
+
+  for (i = 0 ; i < hdr->nx * hdr->ny ; i++)
+    {
+      offset[i + 1] += offset[i];
+      cur[i] = offset[i];
+    }
+
+  if (nruns && (list = (int32_t *) malloc ((size_t) nruns * 2 * sizeof (int32_t))) == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nUnable to allocate memory for the spatial index :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_MEMORY_ALLOCATION_ERROR);
+    }
+
+  for (k = 0 ; k < nruns ; k++)
+    {
+      list[cur[runs[k].cell] * 2] = runs[k].first;
+      list[cur[runs[k].cell] * 2 + 1] = runs[k].count;
+      cur[runs[k].cell]++;
+    }
+
+
+  libslas_index_path (hnd, path, ".lsi");
+
+  if ((fp = fopen64 (path, "wb")) == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nError creating spatial index file :\n%s\nFunction: %s, Line: %d\n"), path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      free (list);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+    }
+
+  if (!fwrite (hdr, sizeof (INDEX_HEADER), 1, fp) || !fwrite (offset, ((size_t) hdr->nx * (size_t) hdr->ny + 1) * sizeof (int64_t), 1, fp) ||
+      (nruns && !fwrite (list, (size_t) nruns * 2 * sizeof (int32_t), 1, fp)))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing spatial index file :\n%s\nFunction: %s, Line: %d\n"), path, strerror (errno),
+               __FUNCTION__, __LINE__ - 4);
+      fclose (fp);
+      remove (path);
+      free (list);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+    }
+
+  free (list);
+
+  if (fclose (fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError closing spatial index file :\n%s\nFunction: %s, Line: %d\n"), path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      remove (path);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+    }
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_build_spatial_index
+
+ - Purpose:     Builds a spatial index sidecar file for a LAS file so that
+                libslas_query_bbox can find the points in an area without reading the whole
+                file.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+                - LIBSLAS_INDEX_ERROR
+                - Error value from libslas_read_raw_point_data
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                The index is a grid laid over the X/Y bounds in the header with about
+                INDEX_POINTS_PER_CELL (4096) points per cell and up to INDEX_MAX_CELLS (1024)
+                cells on a side.  For each cell we store the runs of consecutive records that
+                fall in it.  LAS files are usually written in scan order so each cell is a few
+                runs rather than thousands of scattered records.  The index is written to a
+                sidecar file with the same name as the LAS file and a .lsi extension.  Building
+                it takes one sequential pass through the point data.
+
+                Unlike most of the API, this has to allocate memory.  We need about 16 bytes
+                per cell and 12 bytes per run while we're building it.
+
+                The size and modification time of the LAS file are saved in the index.  If the
+                file is changed in any way after the index is built (appended to, updated, or
+                rewritten by another program) libslas_query_bbox will refuse to use the index
+                until you build it again.  If you're creating (or appending to) the file, close
+                it before you build the index since closing it rewrites the header.
+
+*********************************************************************************************/
+
+int32_t libslas_build_spatial_index (int32_t hnd)
 {
-  int32_t  x, y, z, pos;
-  int64_t  addr;
-  uint8_t  data[POINT_DATA_SIZE], rets, cls;
+  int32_t       status;
+  int64_t       *cur, *offset, nruns;
+  double        width, height;
+  INDEX_HEADER  hdr;
+  INDEX_RUN     *runs;
 
 
-  /*  Check for record out of bounds.  */
+  /*  Lay out the grid.  Add cells along whichever side has the bigger cells until we have enough.  */
+
+  memset (&hdr, 0, sizeof (INDEX_HEADER));
+  hdr.magic = INDEX_MAGIC;
+  hdr.number_of_point_records = LAS (hnd).header.number_of_point_records;
+  hdr.min_x = LAS (hnd).header.min_x;
+  hdr.min_y = LAS (hnd).header.min_y;
+  hdr.max_x = LAS (hnd).header.max_x;
+  hdr.max_y = LAS (hnd).header.max_y;
 
-  if (recnum >= las[hnd].header.number_of_point_records || recnum < 0)
+  width = MAX (hdr.max_x - hdr.min_x, 0.0);
+  height = MAX (hdr.max_y - hdr.min_y, 0.0);
+
+  hdr.nx = hdr.ny = 1;
+  while ((int64_t) hdr.nx * (int64_t) hdr.ny * INDEX_POINTS_PER_CELL < (int64_t) hdr.number_of_point_records &&
+         (hdr.nx < INDEX_MAX_CELLS || hdr.ny < INDEX_MAX_CELLS))
     {
-      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nInvalid record number.\nFunction: %s, Line: %d\n"), las[hnd].path, recnum,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
+      if ((width / hdr.nx >= height / hdr.ny && hdr.nx < INDEX_MAX_CELLS) || hdr.ny == INDEX_MAX_CELLS)
+        {
+          hdr.nx++;
+        }
+      else
+        {
+          hdr.ny++;
+        }
+    }
+
+  hdr.cell_x = width > 0.0 ? width / hdr.nx : 1.0;
+  hdr.cell_y = height > 0.0 ? height / hdr.ny : 1.0;
+
+
+  cur = (int64_t *) malloc ((size_t) hdr.nx * (size_t) hdr.ny * sizeof (int64_t));
+  offset = (int64_t *) calloc ((size_t) hdr.nx * (size_t) hdr.ny + 1, sizeof (int64_t));
+
+  if (cur == NULL || offset == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nUnable to allocate memory for the spatial index :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      free (cur);
+      free (offset);
+      return (libslas_error.libslas = LIBSLAS_MEMORY_ALLOCATION_ERROR);
+    }
+
+
+  status = libslas_find_index_runs (hnd, &hdr, cur, offset, &runs, &nruns);
+
+
+  /*  The index goes with the file as it is now.  */
+
+  if (!status && libslas_get_file_stamp (hnd, &hdr.stamp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError getting LAS file size and modification time :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      status = libslas_error.libslas = LIBSLAS_INDEX_ERROR;
+    }
+
+  if (!status) status = libslas_write_spatial_index (hnd, &hdr, cur, offset, runs, nruns);
+
+
+  free (runs);
+  free (offset);
+  free (cur);
+
+
+  return (status);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_query_bbox
+
+ - Purpose:     Uses the spatial index sidecar file to find the runs of point data records
+                that may be inside a bounding box.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - xmin           =    Minimum X of the bounding box
+                - ymin           =    Minimum Y of the bounding box
+                - xmax           =    Maximum X of the bounding box
+                - ymax           =    Maximum Y of the bounding box
+                - max_runs       =    Number of runs that will fit in runs
+                - runs           =    The returned runs, 2 * max_runs int32_t values (first
+                                      record number and number of records of each run)
+
+ - Returns:
+                - The number of runs (0 or positive)
+                - LIBSLAS_INDEX_ERROR
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                You have to build the index with libslas_build_spatial_index first.  The runs
+                are sorted by record number and adjacent runs are merged so you can read them
+                with libslas_read_point_data_range (or libslas_read_raw_point_data).  The runs
+                cover every record in every grid cell that touches the box so you still have to
+                check each point against the box.  Only the parts of the index we need are read.
+
+                If the returned value is larger than max_runs there wasn't enough room.  Only
+                the first max_runs runs (unsorted) were returned.  Call it again with room for
+                at least that many runs.
+
+*********************************************************************************************/
+
+int32_t libslas_query_bbox (int32_t hnd, double xmin, double ymin, double xmax, double ymax, int32_t max_runs, int32_t *runs)
+{
+  int32_t       i, j, ix0, ix1, iy0, iy1, iy, num, total = 0, list[2 * 1024];
+  int64_t       range[2], k;
+  char          path[1024];
+  INDEX_HEADER  hdr;
+  FILE_STAMP    stamp;
+  FILE          *fp;
+
+
+  libslas_index_path (hnd, path, ".lsi");
+
+  if ((fp = fopen64 (path, "rb")) == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nError opening spatial index file (see libslas_build_spatial_index) :\n%s\nFunction: %s, Line: %d\n"), path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+    }
+
+
+  /*  Make sure the index is ours and that it goes with the file as it is now (FILE_STAMP has no padding so memcmp is
+      safe).  */
+
+  if (!fread (&hdr, sizeof (INDEX_HEADER), 1, fp) || hdr.magic != INDEX_MAGIC || libslas_get_file_stamp (hnd, &stamp) ||
+      memcmp (&stamp, &hdr.stamp, sizeof (FILE_STAMP)) ||
+      hdr.number_of_point_records != LAS (hnd).header.number_of_point_records || hdr.min_x != LAS (hnd).header.min_x ||
+      hdr.min_y != LAS (hnd).header.min_y || hdr.max_x != LAS (hnd).header.max_x || hdr.max_y != LAS (hnd).header.max_y)
+    {
+      sprintf (libslas_error.info, _("File : %s\nSpatial index file is invalid or out of date (see libslas_build_spatial_index).\nFunction: %s, Line: %d\n"), path,
+               __FUNCTION__, __LINE__ - 6);
+      fclose (fp);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
     }
 
 
-  addr = (int64_t) las[hnd].header.offset_to_point_data + (int64_t) las[hnd].header.point_data_record_length * (int64_t) recnum;
+  /*  Nothing to find if the box misses the file.  */
 
+  if (xmax < hdr.min_x || xmin > hdr.max_x || ymax < hdr.min_y || ymin > hdr.max_y || xmax < xmin || ymax < ymin)
+    {
+      fclose (fp);
+      return (0);
+    }
+
+
+  ix0 = MIN (MAX ((int32_t) ((MAX (xmin, hdr.min_x) - hdr.min_x) / hdr.cell_x), 0), hdr.nx - 1);
+  ix1 = MIN (MAX ((int32_t) ((MIN (xmax, hdr.max_x) - hdr.min_x) / hdr.cell_x), 0), hdr.nx - 1);
+  iy0 = MIN (MAX ((int32_t) ((MAX (ymin, hdr.min_y) - hdr.min_y) / hdr.cell_y), 0), hdr.ny - 1);
+  iy1 = MIN (MAX ((int32_t) ((MIN (ymax, hdr.max_y) - hdr.min_y) / hdr.cell_y), 0), hdr.ny - 1);
 
-  /*  Don't do the fseek if we're already at the correct point.  */
 
-  if (las[hnd].pos != addr)
+  /*  The runs for the cells ix0 through ix1 of a row are all together in the file.  */
+
+  for (iy = iy0 ; iy <= iy1 ; iy++)
     {
-      if (fseeko64 (las[hnd].fp, addr, SEEK_SET) < 0)
+      if (fseeko64 (fp, (int64_t) sizeof (INDEX_HEADER) + ((int64_t) iy * hdr.nx + ix0) * (int64_t) sizeof (int64_t), SEEK_SET) < 0 ||
+          !fread (&range[0], sizeof (int64_t), 1, fp) ||
+          fseeko64 (fp, (int64_t) sizeof (INDEX_HEADER) + ((int64_t) iy * hdr.nx + ix1 + 1) * (int64_t) sizeof (int64_t), SEEK_SET) < 0 ||
+          !fread (&range[1], sizeof (int64_t), 1, fp) ||
+          fseeko64 (fp, (int64_t) sizeof (INDEX_HEADER) + ((int64_t) hdr.nx * hdr.ny + 1) * (int64_t) sizeof (int64_t) +
+                    range[0] * 2 * (int64_t) sizeof (int32_t), SEEK_SET) < 0)
         {
-          sprintf (libslas_error.info, _("File : %s\nError during fseek prior to reading LAS record :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-          return (libslas_error.libslas = LIBSLAS_READ_FSEEK_ERROR);
+          sprintf (libslas_error.info, _("File : %s\nError reading spatial index file :\n%s\nFunction: %s, Line: %d\n"), path, strerror (errno),
+                   __FUNCTION__, __LINE__ - 8);
+          fclose (fp);
+          return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
         }
-    }
 
+      for (k = range[0] ; k < range[1] ; k += num)
+        {
+          num = (int32_t) MIN ((int64_t) 1024, range[1] - k);
+
+          if (!fread (list, (size_t) num * 2 * sizeof (int32_t), 1, fp))
+            {
+              sprintf (libslas_error.info, _("File : %s\nError reading spatial index file :\n%s\nFunction: %s, Line: %d\n"), path, strerror (errno),
+                       __FUNCTION__, __LINE__ - 3);
+              fclose (fp);
+              return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+            }
 
-  memset (record, 0, sizeof (LIBSLAS_POINT_DATA));
-  memset (data, 0, POINT_DATA_SIZE);
+          for (i = 0 ; i < num ; i++)
+            {
+              if (total < max_runs)
+                {
+                  runs[total * 2] = list[i * 2];
+                  runs[total * 2 + 1] = list[i * 2 + 1];
+                }
 
+              total++;
+            }
+        }
+    }
 
-  /*  Read the record.  */
+  fclose (fp);
 
-  if (!fread (data, las[hnd].header.point_data_record_length, 1, las[hnd].fp))
+
+  /*  If they all fit, sort them and merge the ones that touch.  */
+
+  if (total <= max_runs && total)
     {
-      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nError reading LAS record :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, recnum, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_READ_ERROR);
+      qsort (runs, total, 2 * sizeof (int32_t), libslas_compare_runs);
+
+      for (i = 1, j = 0 ; i < total ; i++)
+        {
+          if (runs[j * 2] + runs[j * 2 + 1] == runs[i * 2])
+            {
+              runs[j * 2 + 1] += runs[i * 2 + 1];
+            }
+          else
+            {
+              j++;
+              runs[j * 2] = runs[i * 2];
+              runs[j * 2 + 1] = runs[i * 2 + 1];
+            }
+        }
+
+      total = j + 1;
     }
 
 
-  /*  Set the current position.  */
+  return (total);
+}
 
-  las[hnd].pos = ftello64 (las[hnd].fp);
 
 
-  /*  Get the data out of the buffer.  */
+/********************************************************************************************/
+/*!
 
-  pos = 0;
-  memcpy (&x, &data[pos], 4); pos += 4;
-  memcpy (&y, &data[pos], 4); pos += 4;
-  memcpy (&z, &data[pos], 4); pos += 4;
-  memcpy (&record->intensity, &data[pos], 2); pos += 2;
-  memcpy (&rets, &data[pos], 1); pos += 1;
-  memcpy (&cls, &data[pos], 1); pos += 1;
-  memcpy (&record->scan_angle_rank, &data[pos], 1); pos += 1;
-  memcpy (&record->user_data, &data[pos], 1); pos += 1;
-  memcpy (&record->point_source_id, &data[pos], 2); pos += 2;
+ - Function:    libslas_build_time_index
+
+ - Purpose:     Finds the minimum and maximum GPS time of every TIME_CHUNK_SIZE point data
+                records, and whether the records are in GPS time order, and caches them in the
+                handle.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_NO_GPS_TIME_ERROR
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+                - Error value from libslas_read_raw_point_data
+
+ - Caveats:     If the number of point records hasn't changed since the last time we built it
+                we don't do anything.  The GPS time can't be changed by the update functions so
+                that's the only way it can be out of date.
 
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
+
+*********************************************************************************************/
 
-  switch (las[hnd].header.point_data_format_id)
+static int32_t libslas_build_time_index (int32_t hnd)
+{
+  int32_t  i, j, num, rec_length, block_count, chunk, chunks;
+  double   gps_time, last_time = -1.0e300, *time_index;
+  uint8_t  block[POINT_BLOCK_SIZE], sorted = 1;
+
+
+  if (LAS (hnd).header.point_data_format_id != 1 && LAS (hnd).header.point_data_format_id != 3)
     {
-    case 1:
-      memcpy (&record->gps_time, &data[pos], 8); pos += 8;
-      break;
+      sprintf (libslas_error.info, _("File : %s\nPoint data format %d doesn't have GPS time.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               LAS (hnd).header.point_data_format_id, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_NO_GPS_TIME_ERROR);
+    }
 
-    case 2:
-      memcpy (&record->red, &data[pos], 2); pos += 2;
-      memcpy (&record->green, &data[pos], 2); pos += 2;
-      memcpy (&record->blue, &data[pos], 2); pos += 2;
-      break;
 
-    case 3:
-      memcpy (&record->gps_time, &data[pos], 8); pos += 8;
-      memcpy (&record->red, &data[pos], 2); pos += 2;
-      memcpy (&record->green, &data[pos], 2); pos += 2;
-      memcpy (&record->blue, &data[pos], 2); pos += 2;
-      break;
+  if (LAS_COLD (hnd).time_index != NULL && LAS_COLD (hnd).time_count == LAS (hnd).header.number_of_point_records) return (LIBSLAS_SUCCESS);
+
+  libslas_free_time_index (hnd);
+
+
+  chunks = (int32_t) (((int64_t) LAS (hnd).header.number_of_point_records + TIME_CHUNK_SIZE - 1) / TIME_CHUNK_SIZE);
+
+  if ((time_index = (double *) malloc ((size_t) MAX (chunks, 1) * 2 * sizeof (double))) == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nUnable to allocate memory for the GPS time index :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_MEMORY_ALLOCATION_ERROR);
     }
 
 
-  /*  If we have to swap the record, do so.  */
+  /*  Read a block at a time.  GPS time is at byte 20 in formats 1 and 3.  */
 
-  if (las[hnd].swap)
+  rec_length = LAS (hnd).header.point_data_record_length;
+  block_count = POINT_BLOCK_SIZE / rec_length;
+
+  for (i = 0 ; i < (int32_t) LAS (hnd).header.number_of_point_records ; i += num)
     {
-      libslas_swap_uint32_t ((uint32_t *) &x);
-      libslas_swap_uint32_t ((uint32_t *) &y);
-      libslas_swap_uint32_t ((uint32_t *) &z);
-      libslas_swap_uint16_t (&record->intensity);
-      libslas_swap_uint16_t (&record->point_source_id);
+      num = MIN (block_count, (int32_t) LAS (hnd).header.number_of_point_records - i);
 
-      switch (las[hnd].header.point_data_format_id)
+      if (libslas_read_raw_point_data (hnd, i, num, block))
         {
-        case 1:
-          libslas_swap_double (&record->gps_time);
-          break;
+          free (time_index);
+          return (libslas_error.libslas);
+        }
 
-        case 2:
-          libslas_swap_uint16_t (&record->red);
-          libslas_swap_uint16_t (&record->green);
-          libslas_swap_uint16_t (&record->blue);
-          break;
+      for (j = 0 ; j < num ; j++)
+        {
+          chunk = (i + j) / TIME_CHUNK_SIZE;
 
-        case 3:
-          libslas_swap_double (&record->gps_time);
-          libslas_swap_uint16_t (&record->red);
-          libslas_swap_uint16_t (&record->green);
-          libslas_swap_uint16_t (&record->blue);
-          break;
+          if (!((i + j) % TIME_CHUNK_SIZE))
+            {
+              time_index[chunk * 2] = 1.0e300;
+              time_index[chunk * 2 + 1] = -1.0e300;
+            }
+
+          memcpy (&gps_time, &block[j * rec_length + 20], 8);
+          if (LAS (hnd).swap) libslas_swap_double (&gps_time);
+
+          time_index[chunk * 2] = MIN (time_index[chunk * 2], gps_time);
+          time_index[chunk * 2 + 1] = MAX (time_index[chunk * 2 + 1], gps_time);
+
+
+          /*  While we're at it, see if they're in time order (see libslas_check_time_sorted).  */
+
+          if (gps_time < last_time) sorted = 0;
+          last_time = gps_time;
+        }
+    }
+
+
+  LAS_COLD (hnd).time_index = time_index;
+  LAS_COLD (hnd).time_count = LAS (hnd).header.number_of_point_records;
+  LAS_COLD (hnd).time_sorted = sorted;
+
+
+  return (LIBSLAS_SUCCESS);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_query_time_window
+
+ - Purpose:     Finds the runs of point data records that may have a GPS time inside a time
+                window.
+
+ - Author:      agent (agent@local)
+
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
+                - t0             =    Start of the time window
+                - t1             =    End of the time window
+                - max_runs       =    Number of runs that will fit in runs
+                - runs           =    The returned runs, 2 * max_runs int32_t values (first
+                                      record number and number of records of each run)
+
+ - Returns:
+                - The number of runs (0 or positive)
+                - LIBSLAS_NO_GPS_TIME_ERROR
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+                - Error value from libslas_read_raw_point_data
+
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                The first time this is called on a handle we read all of the GPS times and save
+                the minimum and maximum of every TIME_CHUNK_SIZE (65536) records.  After that
+                (until the number of records changes) we only look at the saved times.  The
+                runs are the chunks whose times overlap [t0, t1], in record order with
+                adjacent chunks merged, so you can read them with
+                libslas_read_point_data_range (or libslas_read_raw_point_data).  You still have
+                to check the time of each point.  Because of the first call, don't call this
+                from more than one thread at a time with the same handle.
+
+                If the returned value is larger than max_runs there wasn't enough room.  Only
+                the first max_runs runs were returned.
+
+                Only point data formats 1 and 3 have GPS time.
+
+*********************************************************************************************/
+
+int32_t libslas_query_time_window (int32_t hnd, double t0, double t1, int32_t max_runs, int32_t *runs)
+{
+  int32_t i, first, num, end = -1, chunks, total = 0;
+
+
+  if (libslas_build_time_index (hnd)) return (libslas_error.libslas);
+
+
+  chunks = (int32_t) (((int64_t) LAS (hnd).header.number_of_point_records + TIME_CHUNK_SIZE - 1) / TIME_CHUNK_SIZE);
+
+  for (i = 0 ; i < chunks ; i++)
+    {
+      if (LAS_COLD (hnd).time_index[i * 2] > t1 || LAS_COLD (hnd).time_index[i * 2 + 1] < t0) continue;
+
+      first = i * TIME_CHUNK_SIZE;
+      num = MIN (TIME_CHUNK_SIZE, (int32_t) LAS (hnd).header.number_of_point_records - first);
+
+
+      /*  Either add it to the last run or start a new one.  */
+
+      if (first == end)
+        {
+          if (total <= max_runs) runs[(total - 1) * 2 + 1] += num;
+        }
+      else
+        {
+          if (total < max_runs)
+            {
+              runs[total * 2] = first;
+              runs[total * 2 + 1] = num;
+            }
+
+          total++;
         }
+
+      end = first + num;
     }
 
 
-  /*  Now put the rest of the data into the structure.  */
+  return (total);
+}
+
+
+
+/********************************************************************************************/
+/*!
+
+ - Function:    libslas_check_time_sorted
+
+ - Purpose:     Checks to see if the point data records in a LAS file are in GPS time order.
 
-  record->x = ((double) x * las[hnd].header.x_scale_factor) + las[hnd].header.x_offset;
-  record->y = ((double) y * las[hnd].header.y_scale_factor) + las[hnd].header.y_offset;
-  record->z = (float) (((double) z * las[hnd].header.z_scale_factor) + las[hnd].header.z_offset);
-  record->return_number = rets & 0x03;
-  record->number_of_returns = (rets & 0x38) >> 3;
-  record->edge_of_flightline = (rets & 0x40) >> 6;
-  record->scan_direction_flag = (rets & 0x80) >> 7;
-  record->classification = cls & 0x1f;
-  record->synthetic = (cls & 0x20) >> 5;
-  record->key_point = (cls & 0x40) >> 6;
-  record->withheld = (cls & 0x80) >> 7;
+ - Author:      agent (agent@local)
 
-  las[hnd].at_end = 0;
-  las[hnd].modified = 0;
-  las[hnd].write = 0;
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
 
+ - Returns:
+                - 1 if the records are in GPS time order, otherwise 0
+                - LIBSLAS_NO_GPS_TIME_ERROR
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+                - Error value from libslas_read_raw_point_data
 
-  return (libslas_error.libslas = LIBSLAS_SUCCESS);
-}
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                The check is done in the same pass through the file that builds the GPS time
+                index (see libslas_query_time_window) and the answer is saved along with it.  So,
+                the first call costs one read of the point data and the rest are free (until
+                the number of records changes).  Don't call this from more than one thread at a
+                time with the same handle.
+
+*********************************************************************************************/
 
+int32_t libslas_check_time_sorted (int32_t hnd)
+{
+  if (libslas_build_time_index (hnd)) return (libslas_error.libslas);
+
+  return (LAS_COLD (hnd).time_sorted);
+}
 
 
 
 /********************************************************************************************/
 /*!
 
- - Function:    libslas_append_point_data
+ - Function:    libslas_find_time
 
- - Purpose:     Append a LAS point data record.
+ - Purpose:     Finds the first point data record with a GPS time greater than or equal to a
+                given time in a LAS file that is in GPS time order.
 
- - Author:      Jan C. Depner (area.based.editor@gmail.com)
+ - Author:      agent (agent@local)
 
- - Date:        07/16/14
+ - Date:        10/16/26
 
  - Arguments:
                 - hnd            =    The file handle
-                - record         =    The LIBSLAS_POINT_DATA structure to be written
+                - t              =    The GPS time
 
  - Returns:
-                - LIBSLAS_SUCCESS
-                - LIBSLAS_APPEND_ERROR
-                - LIBSLAS_VALUE_OUT_OF_RANGE_ERROR
-                - LIBSLAS_WRITE_ERROR
+                - The record number (0 through number_of_point_records, the latter if all of
+                  the records are earlier than t)
+                - LIBSLAS_NO_GPS_TIME_ERROR
+                - Error value from libslas_read_point_data_fields
 
- - Caveats:     All returned error values are less than zero.  Success or a file handle
-                will be greater than or equal to zero.  A simple test for failure is to
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
                 check to see if the return is less than zero.
 
-                This function is only used to append records when creating a file.  DO NOT
-                try to use it to update fields in the point data record.  It won't work.
-                Not only that but, if you were to read and write the x, y, and z fields
-                over and over you would continuously be aliasing them since they're scaled
-                offset integers.  The round off would cause data "creep".
+                This is a binary search so it only reads about log2 (number_of_point_records)
+                GPS times (using libslas_read_point_data_fields).  Most files come straight off
+                the sensor in time order so, to get all of the points between t0 and t1, read
+                from libslas_find_time (hnd, t0) up to (but not including) the record after
+                the last one at t1.  No index is needed.  If the GPS time index has already been
+                built (see libslas_query_time_window) we use it to narrow the search down to one
+                chunk first.
+
+                If the file isn't in time order the answer is meaningless.  If you're not sure,
+                use libslas_check_time_sorted.
 
 *********************************************************************************************/
 
-int32_t libslas_append_point_data (int32_t hnd, LIBSLAS_POINT_DATA *record)
+int32_t libslas_find_time (int32_t hnd, double t)
 {
-  int32_t  x, y, z, pos;
-  uint8_t  data[POINT_DATA_SIZE], rets, cls;
-
+  int32_t             lo, hi, mid, chunk, chunks;
+  LIBSLAS_POINT_DATA  record;
 
-  /*  Appending a record is only allowed if you are creating a new file.  */
 
-  if (!las[hnd].created)
+  if (LAS (hnd).header.point_data_format_id != 1 && LAS (hnd).header.point_data_format_id != 3)
     {
-      sprintf (libslas_error.info, _("File : %s\nAppending to pre-existing LAS file not allowed.\nFunction: %s, Line: %d\n"), las[hnd].path,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_APPEND_ERROR);
+      sprintf (libslas_error.info, _("File : %s\nPoint data format %d doesn't have GPS time.\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               LAS (hnd).header.point_data_format_id, __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_NO_GPS_TIME_ERROR);
     }
 
 
-  las[hnd].at_end = 1;
+  lo = 0;
+  hi = (int32_t) LAS (hnd).header.number_of_point_records;
 
 
-  /*  Check for min and max x, y, and z since we're appending a record.  */
-
-  las[hnd].header.min_x = MIN (las[hnd].header.min_x, record->x);
-  las[hnd].header.max_x = MAX (las[hnd].header.max_x, record->x);
-  las[hnd].header.min_y = MIN (las[hnd].header.min_y, record->y);
-  las[hnd].header.max_y = MAX (las[hnd].header.max_y, record->y);
-  las[hnd].header.min_z = MIN (las[hnd].header.min_z, record->z);
-  las[hnd].header.max_z = MAX (las[hnd].header.max_z, record->z);
+  /*  If we have the GPS time index, the answer is in the first chunk whose maximum time is at or after t.  */
 
+  if (LAS_COLD (hnd).time_index != NULL && LAS_COLD (hnd).time_count == LAS (hnd).header.number_of_point_records)
+    {
+      chunks = (hi + TIME_CHUNK_SIZE - 1) / TIME_CHUNK_SIZE;
 
-  /*  Increment the number of records counter in the header.  */
+      for (chunk = 0 ; chunk < chunks && LAS_COLD (hnd).time_index[chunk * 2 + 1] < t ; chunk++);
 
-  las[hnd].header.number_of_point_records++;
+      lo = chunk * TIME_CHUNK_SIZE;
+      if (chunk < chunks) hi = MIN (hi, lo + TIME_CHUNK_SIZE);
+      lo = MIN (lo, hi);
+    }
 
 
-  /*  Check the return number.  */
+  /*  Find the first record that isn't earlier than t.  */
 
-  if (record->return_number < 1 || record->return_number > 5)
+  while (lo < hi)
     {
-      sprintf (libslas_error.info, _("File : %s\nReturn number %d is out of range (1-5).\nFunction: %s, Line: %d\n"), las[hnd].path, record->return_number,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_RETURN_NUMBER_OUT_OF_RANGE_ERROR);
+      mid = lo + (hi - lo) / 2;
+
+      if (libslas_read_point_data_fields (hnd, mid, 1, &record, LIBSLAS_FIELD_GPS_TIME)) return (libslas_error.libslas);
+
+      if (record.gps_time < t)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
     }
 
 
-  /*  Increment the number of points by return.  */
+  return (lo);
+}
 
-  las[hnd].header.number_of_points_by_return[record->return_number - 1]++;
 
 
-  /*  Get the data out of the structure.  */
+/********************************************************************************************/
+/*!
 
-  x = NINT64 ((record->x - las[hnd].header.x_offset) / las[hnd].header.x_scale_factor);
-  y = NINT64 ((record->y - las[hnd].header.y_offset) / las[hnd].header.y_scale_factor);
-  z = NINT64 ((record->z - las[hnd].header.z_offset) / las[hnd].header.z_scale_factor);
+ - Function:    libslas_build_zone_map
 
+ - Purpose:     Builds a zone map sidecar file for a LAS file so that libslas_query_zone_map
+                can skip the chunks of point data records that can't match a filter.
 
-  /*  Pack the bit fields.  */
+ - Author:      agent (agent@local)
 
-  rets = 0;
-  rets |= record->return_number;
-  rets |= (record->number_of_returns << 3);
-  rets |= (record->edge_of_flightline << 6);
-  rets |= (record->scan_direction_flag << 7);
-  cls = 0;
-  cls |= record->classification;
-  cls |= (record->withheld << 7);
-  cls |= (record->key_point << 6);
-  cls |= (record->synthetic << 5);
+ - Date:        10/16/26
+
+ - Arguments:
+                - hnd            =    The file handle
 
+ - Returns:
+                - LIBSLAS_SUCCESS
+                - LIBSLAS_MEMORY_ALLOCATION_ERROR
+                - LIBSLAS_INDEX_ERROR
+                - Error value from libslas_read_raw_point_data
 
-  /*  If we have to swap the record, do so.  */
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
+
+                For every ZONE_CHUNK_SIZE (65536) records we save the minimum and maximum X, Y,
+                Z, and intensity, a bit for each classification, and a bit for each return
+                number.  That's 36 bytes per chunk.  The zone map is written to a sidecar file
+                with the same name as the LAS file and a .lsz extension.  Building it takes one
+                sequential pass through the point data.
+
+                The size and modification time of the LAS file are saved in the zone map.  If
+                the file is changed in any way after the zone map is built (appended to,
+                updated, or rewritten by another program) libslas_query_zone_map will refuse to
+                use it until you build it again.  If you're creating (or appending to) the
+                file, close it before you build the zone map since closing it rewrites the
+                header.
 
-  if (las[hnd].swap)
+*********************************************************************************************/
+
+int32_t libslas_build_zone_map (int32_t hnd)
+{
+  int32_t      i, j, k, num, rec_length, block_count, chunk, xyz[3];
+  uint16_t     intensity;
+  uint8_t      block[POINT_BLOCK_SIZE], *raw;
+  char         path[1024];
+  ZONE_HEADER  hdr;
+  ZONE_ENTRY   *zone;
+  FILE         *fp;
+
+
+  memset (&hdr, 0, sizeof (ZONE_HEADER));
+  hdr.magic = ZONE_MAGIC;
+  hdr.number_of_point_records = LAS (hnd).header.number_of_point_records;
+  hdr.min_x = LAS (hnd).header.min_x;
+  hdr.min_y = LAS (hnd).header.min_y;
+  hdr.min_z = LAS (hnd).header.min_z;
+  hdr.max_x = LAS (hnd).header.max_x;
+  hdr.max_y = LAS (hnd).header.max_y;
+  hdr.max_z = LAS (hnd).header.max_z;
+  hdr.chunks = (int32_t) (((int64_t) hdr.number_of_point_records + ZONE_CHUNK_SIZE - 1) / ZONE_CHUNK_SIZE);
+
+
+  /*  Use calloc so that the padding at the end of each entry is zeroed before we write it.  */
+
+  if ((zone = (ZONE_ENTRY *) calloc ((size_t) MAX (hdr.chunks, 1), sizeof (ZONE_ENTRY))) == NULL)
     {
-      libslas_swap_uint32_t ((uint32_t *) &x);
-      libslas_swap_uint32_t ((uint32_t *) &y);
-      libslas_swap_uint32_t ((uint32_t *) &z);
-      libslas_swap_uint16_t (&record->intensity);
-      libslas_swap_uint16_t (&record->point_source_id);
+      sprintf (libslas_error.info, _("File : %s\nUnable to allocate memory for the zone map :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_MEMORY_ALLOCATION_ERROR);
+    }
 
-      switch (las[hnd].header.point_data_format_id)
-        {
-        case 1:
-          libslas_swap_double (&record->gps_time);
-          break;
 
-        case 2:
-          libslas_swap_uint16_t (&record->red);
-          libslas_swap_uint16_t (&record->green);
-          libslas_swap_uint16_t (&record->blue);
-          break;
+  /*  Read a block at a time.  X, Y, and Z are at byte 0, intensity at 12, return number at 14, and classification at 15
+      in all of the point data formats.  */
 
-        case 3:
-          libslas_swap_double (&record->gps_time);
-          libslas_swap_uint16_t (&record->red);
-          libslas_swap_uint16_t (&record->green);
-          libslas_swap_uint16_t (&record->blue);
-          break;
+  rec_length = LAS (hnd).header.point_data_record_length;
+  block_count = POINT_BLOCK_SIZE / rec_length;
+
+  for (i = 0 ; i < (int32_t) hdr.number_of_point_records ; i += num)
+    {
+      num = MIN (block_count, (int32_t) hdr.number_of_point_records - i);
+
+      if (libslas_read_raw_point_data (hnd, i, num, block))
+        {
+          free (zone);
+          return (libslas_error.libslas);
         }
-    }
 
+      for (j = 0, raw = block ; j < num ; j++, raw += rec_length)
+        {
+          chunk = (i + j) / ZONE_CHUNK_SIZE;
 
-  /*  Put the data into the buffer.  */
+          memcpy (xyz, raw, 12);
+          memcpy (&intensity, &raw[12], 2);
 
-  pos = 0;
-  memcpy (&data[pos], &x, 4); pos += 4;
-  memcpy (&data[pos], &y, 4); pos += 4;
-  memcpy (&data[pos], &z, 4); pos += 4;
-  memcpy (&data[pos], &record->intensity, 2); pos += 2;
-  memcpy (&data[pos], &rets, 1); pos += 1;
-  memcpy (&data[pos], &cls, 1); pos += 1;
-  memcpy (&data[pos], &record->scan_angle_rank, 1); pos += 1;
-  memcpy (&data[pos], &record->user_data, 1); pos += 1;
-  memcpy (&data[pos], &record->point_source_id, 2); pos += 2;
+          if (LAS (hnd).swap)
+            {
+              for (k = 0 ; k < 3 ; k++) libslas_swap_uint32_t ((uint32_t *) &xyz[k]);
+              libslas_swap_uint16_t (&intensity);
+            }
 
+          if (!((i + j) % ZONE_CHUNK_SIZE))
+            {
+              for (k = 0 ; k < 3 ; k++) zone[chunk].min[k] = zone[chunk].max[k] = xyz[k];
+              zone[chunk].min_intensity = zone[chunk].max_intensity = intensity;
+            }
 
-  switch (las[hnd].header.point_data_format_id)
-    {
-    case 1:
-      memcpy (&data[pos], &record->gps_time, 8); pos += 8;
-      break;
+          for (k = 0 ; k < 3 ; k++)
+            {
+              zone[chunk].min[k] = MIN (zone[chunk].min[k], xyz[k]);
+              zone[chunk].max[k] = MAX (zone[chunk].max[k], xyz[k]);
+            }
 
-    case 2:
-      memcpy (&data[pos], &record->red, 2); pos += 2;
-      memcpy (&data[pos], &record->green, 2); pos += 2;
-      memcpy (&data[pos], &record->blue, 2); pos += 2;
-      break;
+          zone[chunk].min_intensity = MIN (zone[chunk].min_intensity, intensity);
+          zone[chunk].max_intensity = MAX (zone[chunk].max_intensity, intensity);
 
-    case 3:
-      memcpy (&data[pos], &record->gps_time, 8); pos += 8;
-      memcpy (&data[pos], &record->red, 2); pos += 2;
-      memcpy (&data[pos], &record->green, 2); pos += 2;
-      memcpy (&data[pos], &record->blue, 2); pos += 2;
-      break;
+          zone[chunk].classification |= (uint32_t) 1 << (raw[15] & 0x1f);
+          zone[chunk].return_number |= (uint8_t) (1 << (raw[14] & 0x07));
+        }
     }
 
 
-  /*  Write the record.  */
+  /*  The zone map goes with the file as it is now.  */
 
-  if (!fwrite (data, las[hnd].header.point_data_record_length, 1, las[hnd].fp))
+  if (libslas_get_file_stamp (hnd, &hdr.stamp))
     {
-      sprintf (libslas_error.info, _("File : %s\nError writing LAS record :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_WRITE_ERROR);
+      sprintf (libslas_error.info, _("File : %s\nError getting LAS file size and modification time :\n%s\nFunction: %s, Line: %d\n"), LAS_COLD (hnd).path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      free (zone);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
     }
 
 
-  /*  Set the current position.  */
+  libslas_index_path (hnd, path, ".lsz");
 
-  las[hnd].pos = ftello64 (las[hnd].fp);
+  if ((fp = fopen64 (path, "wb")) == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nError creating zone map file :\n%s\nFunction: %s, Line: %d\n"), path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      free (zone);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+    }
 
+  if (!fwrite (&hdr, sizeof (ZONE_HEADER), 1, fp) || (hdr.chunks && !fwrite (zone, (size_t) hdr.chunks * sizeof (ZONE_ENTRY), 1, fp)))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError writing zone map file :\n%s\nFunction: %s, Line: %d\n"), path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      fclose (fp);
+      remove (path);
+      free (zone);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+    }
 
-  las[hnd].at_end = 1;
-  las[hnd].modified = 1;
-  las[hnd].write = 1;
-  las[hnd].data = 1;
+  free (zone);
 
+  if (fclose (fp))
+    {
+      sprintf (libslas_error.info, _("File : %s\nError closing zone map file :\n%s\nFunction: %s, Line: %d\n"), path, strerror (errno),
+               __FUNCTION__, __LINE__ - 3);
+      remove (path);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+    }
 
-  return (libslas_error.libslas = LIBSLAS_SUCCESS);
+  return (LIBSLAS_SUCCESS);
 }
 
 
@@ -1738,171 +8005,199 @@ int32_t libslas_append_point_data (int32_t hnd, LIBSLAS_POINT_DATA *record)
 /********************************************************************************************/
 /*!
 
- - Function:    libslas_update_point_data
+ - Function:    libslas_zone_match
 
- - Purpose:     Updates the user modifiable fields of a LAS point data record without affecting
-                the "non-modifiable" fields.
+ - Purpose:     Checks whether any of the point data records in a zone map chunk might match
+                a filter.
 
- - Author:      Jan C. Depner (area.based.editor@gmail.com)
+ - Author:      agent (agent@local)
 
- - Date:        07/16/14
+ - Date:        10/16/26
 
  - Arguments:
                 - hnd            =    The file handle
-                - recnum         =    The record number of the LAS point data record to be written
-		                      (records start at 0)
-                - record         =    The LIBSLAS_POINT_DATA structure to be updated
+                - zone           =    The zone map entry for the chunk
+                - filter         =    The filter
 
  - Returns:
-                - LIBSLAS_SUCCESS
-                - LIBSLAS_INVALID_RECORD_NUMBER_ERROR
-                - LIBSLAS_UPDATE_FSEEK_ERROR
-                - LIBSLAS_UPDATE_ERROR
-                - LIBSLAS_UPDATE_READ_ERROR
-                - LIBSLAS_NOT_OPEN_FOR_UPDATE_ERROR
+                - 1 if some of the records might match, 0 if none of them can
 
- - Caveats:     All returned error values are less than zero.  Success or a file handle
-                will be greater than or equal to zero.  A simple test for failure is to
-                check to see if the return is less than zero.
+ - Caveats:     The raw X, Y, and Z are scaled and offset the same way libslas_read_point_data
+                does it so that a point right on the edge of a filter range isn't missed.
+
+                This function is static, it is only used internal to the API and is not
+                callable from an external program.
 
 *********************************************************************************************/
 
-int32_t libslas_update_point_data (int32_t hnd, int32_t recnum, LIBSLAS_POINT_DATA *record)
+static uint8_t libslas_zone_match (int32_t hnd, ZONE_ENTRY *zone, LIBSLAS_ZONE_FILTER *filter)
 {
-  int32_t   pos;
-  uint16_t  psid, red, green, blue;
-  uint8_t   data[POINT_DATA_SIZE], cls;
-  int64_t   addr;
-
+  int32_t   k;
+  uint32_t  field[3];
+  double    scale[3], offset[3], min[3], max[3], lo, hi;
+
+
+  field[0] = LIBSLAS_FIELD_X;
+  scale[0] = LAS (hnd).header.x_scale_factor;
+  offset[0] = LAS (hnd).header.x_offset;
+  min[0] = filter->min_x;
+  max[0] = filter->max_x;
+
+  field[1] = LIBSLAS_FIELD_Y;
+  scale[1] = LAS (hnd).header.y_scale_factor;
+  offset[1] = LAS (hnd).header.y_offset;
+  min[1] = filter->min_y;
+  max[1] = filter->max_y;
+
+  field[2] = LIBSLAS_FIELD_Z;
+  scale[2] = LAS (hnd).header.z_scale_factor;
+  offset[2] = LAS (hnd).header.z_offset;
+  min[2] = filter->min_z;
+  max[2] = filter->max_z;
+
+  for (k = 0 ; k < 3 ; k++)
+    {
+      if (!(filter->fields & field[k])) continue;
 
-  /*  Check for LIBSLAS_UPDATE mode.  */
+      lo = (double) zone->min[k] * scale[k] + offset[k];
+      hi = (double) zone->max[k] * scale[k] + offset[k];
 
-  if (las[hnd].mode != LIBSLAS_UPDATE)
-    {
-      sprintf (libslas_error.info, _("File : %s\nNot opened for update.\nFunction: %s, Line: %d\n"), las[hnd].path,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_NOT_OPEN_FOR_UPDATE_ERROR);
+      if (MAX (lo, hi) < min[k] || MIN (lo, hi) > max[k]) return (0);
     }
 
 
-  /*  Check for record out of bounds.  */
+  if ((filter->fields & LIBSLAS_FIELD_INTENSITY) &&
+      (zone->max_intensity < filter->min_intensity || zone->min_intensity > filter->max_intensity)) return (0);
 
-  if (recnum >= las[hnd].header.number_of_point_records || recnum < 0)
-    {
-      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nInvalid record number.\nFunction: %s, Line: %d\n"), las[hnd].path, recnum,
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_INVALID_RECORD_NUMBER_ERROR);
-    }
+  if ((filter->fields & LIBSLAS_FIELD_CLASSIFICATION) && !(zone->classification & filter->classification)) return (0);
 
+  if ((filter->fields & LIBSLAS_FIELD_RETURN_NUMBER) && !(zone->return_number & filter->return_number)) return (0);
 
-  /*  Seek to the record.  */
 
-  addr = (int64_t) las[hnd].header.offset_to_point_data + (int64_t) las[hnd].header.point_data_record_length * (int64_t) recnum;
+  return (1);
+}
 
 
-  if (fseeko64 (las[hnd].fp, addr, SEEK_SET) < 0)
-    {
-      sprintf (libslas_error.info, _("File : %s\nError during fseek prior to updating LAS record :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_UPDATE_FSEEK_ERROR);
-    }
 
+/********************************************************************************************/
+/*!
 
-  /*  Read the record.  */
+ - Function:    libslas_query_zone_map
 
-  if (!fread (data, las[hnd].header.point_data_record_length, 1, las[hnd].fp))
-    {
-      sprintf (libslas_error.info, _("File : %s\nRecord : %d\nError reading LAS record :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, recnum, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_UPDATE_READ_ERROR);
-    }
+ - Purpose:     Uses the zone map sidecar file to find the runs of point data records that may
+                match a filter.
 
+ - Author:      agent (agent@local)
 
-  /*  Modify the fields that can be changed (see libslas.h)  */
+ - Date:        10/16/26
 
-  cls = 0;
-  cls |= record->classification;
-  cls |= (record->withheld << 7);
-  cls |= (record->key_point << 6);
-  cls |= (record->synthetic << 5);
+ - Arguments:
+                - hnd            =    The file handle
+                - filter         =    The filter (see LIBSLAS_ZONE_FILTER in libslas.h)
+                - max_runs       =    Number of runs that will fit in runs
+                - runs           =    The returned runs, 2 * max_runs int32_t values (first
+                                      record number and number of records of each run)
 
+ - Returns:
+                - The number of runs (0 or positive)
+                - LIBSLAS_INDEX_ERROR
 
-  /*  Position to the classification field.  */
+ - Caveats:     All returned error values are less than zero.  A simple test for failure is to
+                check to see if the return is less than zero.
 
-  pos = 15;
-  memcpy (&data[pos], &cls, 1); pos += 1;
+                You have to build the zone map with libslas_build_zone_map first.  The runs are
+                the ZONE_CHUNK_SIZE (65536) record chunks that might have records that pass all
+                of the tests in the filter, in record order with adjacent chunks merged, so you
+                can read them with libslas_read_point_data_range (or
+                libslas_read_raw_point_data).  Every other chunk can be skipped without reading
+                it.  You still have to check each point against the filter.
 
+                If the returned value is larger than max_runs there wasn't enough room.  Only
+                the first max_runs runs were returned.
 
-  /*  Move past the scan_angle_rank field.  */
+*********************************************************************************************/
 
-  pos +=1;
-  memcpy (&data[pos], &record->user_data, 1); pos += 1;
+int32_t libslas_query_zone_map (int32_t hnd, LIBSLAS_ZONE_FILTER *filter, int32_t max_runs, int32_t *runs)
+{
+  int32_t      i, chunk, num, first, count, end = -1, total = 0;
+  char         path[1024];
+  ZONE_HEADER  hdr;
+  ZONE_ENTRY   zone[256];
+  FILE_STAMP   stamp;
+  FILE         *fp;
 
 
-  /*  Swap the point source ID if needed.  */
+  libslas_index_path (hnd, path, ".lsz");
 
-  psid = record->point_source_id;
-  if (las[hnd].swap) libslas_swap_uint16_t (&psid);
-  memcpy (&data[pos], &psid, 2); pos += 2;
+  if ((fp = fopen64 (path, "rb")) == NULL)
+    {
+      sprintf (libslas_error.info, _("File : %s\nError opening zone map file (see libslas_build_zone_map) :\n%s\nFunction: %s, Line: %d\n"), path,
+               strerror (errno), __FUNCTION__, __LINE__ - 3);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+    }
 
 
-  red = record->red;
-  green = record->green;
-  blue = record->blue;
+  /*  Make sure the zone map is ours and that it goes with the file as it is now.  */
 
-  if (las[hnd].header.point_data_format_id > 1)
+  if (!fread (&hdr, sizeof (ZONE_HEADER), 1, fp) || hdr.magic != ZONE_MAGIC || libslas_get_file_stamp (hnd, &stamp) ||
+      memcmp (&stamp, &hdr.stamp, sizeof (FILE_STAMP)) ||
+      hdr.number_of_point_records != LAS (hnd).header.number_of_point_records || hdr.min_x != LAS (hnd).header.min_x ||
+      hdr.min_y != LAS (hnd).header.min_y || hdr.min_z != LAS (hnd).header.min_z || hdr.max_x != LAS (hnd).header.max_x ||
+      hdr.max_y != LAS (hnd).header.max_y || hdr.max_z != LAS (hnd).header.max_z ||
+      hdr.chunks != (int32_t) (((int64_t) hdr.number_of_point_records + ZONE_CHUNK_SIZE - 1) / ZONE_CHUNK_SIZE))
     {
-      /*  If we're using format 3, move past the GPS time.  */
-
-      if (las[hnd].header.point_data_format_id == 3) pos += 8;
+      sprintf (libslas_error.info, _("File : %s\nZone map file is invalid or out of date (see libslas_build_zone_map).\nFunction: %s, Line: %d\n"), path,
+               __FUNCTION__, __LINE__ - 7);
+      fclose (fp);
+      return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
+    }
 
 
-      /*  Swap if we have to.  */
+  for (chunk = 0 ; chunk < hdr.chunks ; chunk += num)
+    {
+      num = MIN (256, hdr.chunks - chunk);
 
-      if (las[hnd].swap)
+      if (!fread (zone, (size_t) num * sizeof (ZONE_ENTRY), 1, fp))
         {
-          libslas_swap_uint16_t (&red);
-          libslas_swap_uint16_t (&green);
-          libslas_swap_uint16_t (&blue);
+          sprintf (libslas_error.info, _("File : %s\nError reading zone map file :\n%s\nFunction: %s, Line: %d\n"), path, strerror (errno),
+                   __FUNCTION__, __LINE__ - 3);
+          fclose (fp);
+          return (libslas_error.libslas = LIBSLAS_INDEX_ERROR);
         }
 
-      memcpy (&data[pos], &red, 2); pos += 2;
-      memcpy (&data[pos], &green, 2); pos += 2;
-      memcpy (&data[pos], &blue, 2); pos += 2;
-    }
+      for (i = 0 ; i < num ; i++)
+        {
+          if (!libslas_zone_match (hnd, &zone[i], filter)) continue;
 
+          first = (chunk + i) * ZONE_CHUNK_SIZE;
+          count = MIN (ZONE_CHUNK_SIZE, (int32_t) hdr.number_of_point_records - first);
 
-  /*  Go back to the beginning of the record.  */
 
-  if (fseeko64 (las[hnd].fp, addr, SEEK_SET) < 0)
-    {
-      sprintf (libslas_error.info, _("File : %s\nError during fseek prior to updating LAS record :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_UPDATE_FSEEK_ERROR);
-    }
+          /*  Either add it to the last run or start a new one.  */
 
+          if (first == end)
+            {
+              if (total <= max_runs) runs[(total - 1) * 2 + 1] += count;
+            }
+          else
+            {
+              if (total < max_runs)
+                {
+                  runs[total * 2] = first;
+                  runs[total * 2 + 1] = count;
+                }
 
-  /*  Write the record.  */
+              total++;
+            }
 
-  if (!fwrite (data, las[hnd].header.point_data_record_length, 1, las[hnd].fp))
-    {
-      sprintf (libslas_error.info, _("File : %s\nError writing LAS record :\n%s\nFunction: %s, Line: %d\n"), las[hnd].path, strerror (errno),
-               __FUNCTION__, __LINE__ - 3);
-      return (libslas_error.libslas = LIBSLAS_WRITE_ERROR);
+          end = first + count;
+        }
     }
 
-
-  /*  Set the current position.  */
-
-  las[hnd].pos = ftello64 (las[hnd].fp);
-
-
-  las[hnd].at_end = 0;
-  las[hnd].modified = 1;
-  las[hnd].write = 1;
+  fclose (fp);
 
 
-  return (libslas_error.libslas = LIBSLAS_SUCCESS);
+  return (total);
 }
 
 
@@ -1912,7 +8207,7 @@ int32_t libslas_update_point_data (int32_t hnd, int32_t recnum, LIBSLAS_POINT_DA
 
  - Function:    libslas_strerror
 
- - Purpose:     Returns the error string related to the latest error.
+ - Purpose:     Returns the error string related to the latest error in the calling thread.
 
  - Author:      Jan C. Depner (area.based.editor@gmail.com)
 
@@ -1938,7 +8233,7 @@ char *libslas_strerror ()
 
  - Function:    libslas_perror
 
- - Purpose:     Prints (to stderr) the latest error messages.
+ - Purpose:     Prints (to stderr) the latest error messages from the calling thread.
 
  - Author:      Jan C. Depner (area.based.editor@gmail.com)
 
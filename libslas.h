@@ -108,7 +108,14 @@ extern "C" {
        - No GDAL requirement
        - No GeoTIFF requirement
        - Low level API written in C, not C++
-       - No allocation/de-allocation of memory within the API
+       - No allocation/de-allocation of memory that the application has to manage.  The API allocates and frees its own
+         internal memory:
+         - the table of open file handles,
+         - the VLR directory of each open file (allocated in libslas_open_las_file, grown by libslas_append_vlr_record,
+           freed in libslas_close_las_file),
+         - the GPS time index of each open file (built by the first call to libslas_query_time_window,
+           libslas_check_time_sorted, or libslas_find_time, freed in libslas_close_las_file),
+         - work space used while libslas_build_spatial_index and libslas_build_zone_map run (freed before they return).
        - Use simple structures for LAS header, VLR header, and point data.
        - Handle Endianness in the API
        - Don't make the application deal with any bit fields in records.  In other words, the API handles packing and unpacking
@@ -141,11 +148,19 @@ extern "C" {
          things in libslas.c but I don't have either platform to build and test on.
        - I've left out anything that would allow you to build this as a DLL on Windows.  Dynamically loaded libraries are a
          giant PITA on Windows due to that __declspec nonsense.  You can build it as a shared library on Linux though ;-)
-       - You can only open 64 LAS files simultaneously.  If that's a problem just go change LIBSLAS_MAX_FILES.
+       - You can open up to LIBSLAS_MAX_FILES (65536) LAS files simultaneously (assuming your system will let you have that
+         many open files).  The handle table grows as files are opened so you don't pay for handles you don't use.
        - The LAS header and the VLR records are not modifiable after they have been written at this time (I don't really have a
          need for it).
        - You cannot add VLR records after the file has been created or after you have written point records (I don't have a need
          for that either).
+       - If you are going to read a lot of point records from a file that you don't need to update, open it with
+         LIBSLAS_READONLY_MMAP.  The point data block is memory mapped and records are unpacked straight from the page cache
+         (which can be shared by any number of processes reading the same file).  On Windows this is the same as LIBSLAS_READONLY.
+       - If you are going to read a huge file once (a nightly QC scan, for instance), open it with LIBSLAS_READONLY_DIRECT.  The
+         point data is read with O_DIRECT so the scan doesn't evict everyone else's data from the page cache.  Give the handle a
+         read-ahead buffer (see libslas_set_read_ahead) or the disk will spend a lot of time waiting on you.  Where O_DIRECT isn't
+         available this is the same as LIBSLAS_READONLY.
 
 
        <br><br>\section read Example read code
@@ -288,6 +303,7 @@ extern "C" {
          LIBSLAS_POINT_DATA              las;
          int32_t                         i, las_handle, pos;
          uint16_t                        var;
+         uint8_t                         *io_buffer;
 
          #
          #
@@ -472,6 +488,14 @@ extern "C" {
            }
 
 
+         /#  Optionally, give the API a few megabytes to stage the point data records in so they get written in big chunks.
+             This buffer belongs to you, don't free it until after you close the LAS file.  #/
+
+         io_buffer = (uint8_t *) malloc (4 * 1024 * 1024);
+
+         if (io_buffer != NULL) libslas_set_io_buffer (las_handle, io_buffer, 4 * 1024 * 1024);
+
+
          /#  Read throught the input file and append the point data records.  #/
 
          for (i = 0 ; i < number_of_records ; i++)
@@ -533,6 +557,8 @@ extern "C" {
 
          libslas_close_las_file (las_handle);
 
+         if (io_buffer != NULL) free (io_buffer);
+
          return (0);
        }
 
@@ -605,20 +631,35 @@ extern "C" {
 
        <br><br>\section threads Thread Safety
 
-       The LIBSLAS I/O library is thread safe if you follow some simple rules.  First, it is only thread safe if you use a unique
-       LIBSLAS file handle for each thread.  Also, the libslas_create_las_file, libslas_open_las_file, and libslas_close_las_file
-       functions are not thread safe due to the fact that they assign or clear the LIBSLAS file handles.  In order to use the
-       library in multiple threads you must open (or create) the LAS files prior to starting the threads and close them after the
-       threads have completed.  Some common sense must be brought to bear when trying to create a multithreaded program that works
-       with LAS files.  When you are creating LAS files, threads should only work with one file.  So, for example, if you want to
-       create 16 LAS files from 16 sets of input data you would create all 16 new LAS files using libslas_create_las_file prior to
-       starting your threads.  After that, each thread would append records to each of the files.  When the threads are finished
-       you would use libslas_close_las_file to close each of the new LAS files.
-
-       If you want multiple threads to read from multiple or single LAS files at the same time you must open each file for each
-       thread to get a separate LIBSLAS file handle for each file and thread.  The static data in the LIBSLAS API is segregated by the 
-       LIBSLAS file handle so there should be no collision problems.  Again, you have to open the files prior to starting your threads
-       and close them after the threads are finished.
+       The LIBSLAS I/O library is thread safe if you follow some simple rules.  First, except for reading point data (see below),
+       it is only thread safe if you use a unique LIBSLAS file handle for each thread.  The libslas_create_las_file,
+       libslas_open_las_file, and libslas_close_las_file functions are thread safe (the handle table is protected by a lock) so
+       threads can open and close their own files whenever they like.  Obviously, you can't close a file in one thread while
+       another thread is still using it.  Some common sense must be brought to bear when trying to create a multithreaded program
+       that works with LAS files.  When you are creating LAS files, only one thread should work with each file.  So, for example,
+       if you want to create 16 LAS files from 16 sets of input data each thread would create one new LAS file using
+       libslas_create_las_file, append records to it, and then use libslas_close_las_file to close it.  The exception is a new
+       file whose point count you know ahead of time.  After libslas_declare_point_count any number of threads can write
+       different ranges of records to it with libslas_write_point_data.
+
+       Point data reads (libslas_read_point_data, libslas_read_point_data_range, libslas_read_point_columns,
+       libslas_read_point_data_fields, libslas_read_point_data_batch, and libslas_read_raw_point_data) use positional reads (pread) on the file descriptor and
+       don't change anything in the LIBSLAS file handle, so any number of threads may read point data through a single LIBSLAS file
+       handle at the same time.  For example, you could open a file once and have 64 threads each read a different range of records
+       from it.  This doesn't extend to reading point data while another thread is appending or updating records in the same file,
+       or to the VLR functions, which use the stdio file position, or to a handle that is being read ahead (see
+       libslas_set_read_ahead).  On Windows there is no pread so each thread still needs its own LIBSLAS file handle there.
+
+       If all you want to do is run every point record in a file through some code using all of your cores,
+       libslas_parallel_scan does the partitioning, threading, reading, and decoding for you.
+
+       If you want multiple threads to do anything else with a single LAS file at the same time you must open the file for each
+       thread to get a separate LIBSLAS file handle for each thread.  The static data in the LIBSLAS API is segregated by the 
+       LIBSLAS file handle so there should be no collision problems.
+
+       Error information is kept per thread.  When a LIBSLAS function fails, libslas_strerror and libslas_perror in that thread
+       report the failure no matter what other threads have been doing in the meantime.  Successful calls don't change the error
+       information.
 
 
        <br><br>\section notes Documentation Notes
@@ -635,16 +676,67 @@ extern "C" {
   */
 
 
-#define       LIBSLAS_MAX_FILES                        64        /*!<  Maximum number of open LAS files.  */
+#define       LIBSLAS_MAX_FILES                        65536     /*!<  Maximum number of open LAS files (must be a multiple of 64).  */
 
 
 #define       LIBSLAS_HEADER_SIZE                      227       /*!<  The header size is always 227 bytes for 1.0, 1.1, and 1.2  */
 
 
+#define       LIBSLAS_MIN_IO_BUFFER_SIZE               65536     /*!<  Minimum size of an application supplied I/O buffer.  */
+
+
   /*  File open modes.  */
 
 #define       LIBSLAS_UPDATE                           0         /*!<  Open file for update.  */
 #define       LIBSLAS_READONLY                         1         /*!<  Open file for read only.  */
+#define       LIBSLAS_READONLY_MMAP                    2         /*!<  Open file for read only with the point data memory mapped.  */
+#define       LIBSLAS_READONLY_DIRECT                  3         /*!<  Open file for read only with the point data read using O_DIRECT.  */
+#define       LIBSLAS_APPEND                           4         /*!<  Open file to append point data records.  */
+
+
+  /*  I/O engines (see libslas_set_io_engine).  */
+
+#define       LIBSLAS_IO_DEFAULT                       0         /*!<  One pread/pwrite per record (or run of records).  */
+#define       LIBSLAS_IO_URING                         1         /*!<  Batches of reads/writes submitted through a Linux io_uring.  */
+
+
+  /*  Access patterns (see libslas_advise).  */
+
+#define       LIBSLAS_ADVISE_NORMAL                    0         /*!<  No particular pattern (the default).  */
+#define       LIBSLAS_ADVISE_SEQUENTIAL                1         /*!<  The records will be read in order.  */
+#define       LIBSLAS_ADVISE_RANDOM                    2         /*!<  The records will be read in random order.  */
+#define       LIBSLAS_ADVISE_WILLNEED                  3         /*!<  The records will be needed soon.  */
+#define       LIBSLAS_ADVISE_DONTNEED                  4         /*!<  The records won't be needed again any time soon.  */
+
+
+  /*  Point data field bits used by libslas_read_point_data_fields and libslas_update_point_data_fields.  */
+
+#define       LIBSLAS_FIELD_X                          0x00000001
+#define       LIBSLAS_FIELD_Y                          0x00000002
+#define       LIBSLAS_FIELD_Z                          0x00000004
+#define       LIBSLAS_FIELD_INTENSITY                  0x00000008
+#define       LIBSLAS_FIELD_RETURN_NUMBER              0x00000010
+#define       LIBSLAS_FIELD_NUMBER_OF_RETURNS          0x00000020
+#define       LIBSLAS_FIELD_SCAN_DIRECTION_FLAG        0x00000040
+#define       LIBSLAS_FIELD_EDGE_OF_FLIGHTLINE         0x00000080
+#define       LIBSLAS_FIELD_CLASSIFICATION             0x00000100
+#define       LIBSLAS_FIELD_SYNTHETIC                  0x00000200
+#define       LIBSLAS_FIELD_KEY_POINT                  0x00000400
+#define       LIBSLAS_FIELD_WITHHELD                   0x00000800
+#define       LIBSLAS_FIELD_SCAN_ANGLE_RANK            0x00001000
+#define       LIBSLAS_FIELD_USER_DATA                  0x00002000
+#define       LIBSLAS_FIELD_POINT_SOURCE_ID            0x00004000
+#define       LIBSLAS_FIELD_GPS_TIME                   0x00008000
+#define       LIBSLAS_FIELD_RED                        0x00010000
+#define       LIBSLAS_FIELD_GREEN                      0x00020000
+#define       LIBSLAS_FIELD_BLUE                       0x00040000
+
+#define       LIBSLAS_FIELD_XYZ                        (LIBSLAS_FIELD_X | LIBSLAS_FIELD_Y | LIBSLAS_FIELD_Z)
+#define       LIBSLAS_FIELD_RGB                        (LIBSLAS_FIELD_RED | LIBSLAS_FIELD_GREEN | LIBSLAS_FIELD_BLUE)
+#define       LIBSLAS_FIELD_ALL                        0x0007ffff
+#define       LIBSLAS_FIELD_MODIFIABLE                 (LIBSLAS_FIELD_CLASSIFICATION | LIBSLAS_FIELD_SYNTHETIC | LIBSLAS_FIELD_KEY_POINT | \
+                                                        LIBSLAS_FIELD_WITHHELD | LIBSLAS_FIELD_USER_DATA | LIBSLAS_FIELD_POINT_SOURCE_ID | \
+                                                        LIBSLAS_FIELD_RGB)
 
 
   /*  Error conditions.  */
@@ -680,6 +772,18 @@ extern "C" {
 #define       LIBSLAS_VLR_WRITE_ERROR                  -28
 #define       LIBSLAS_VLR_WRITE_FSEEK_ERROR            -29
 #define       LIBSLAS_WRITE_ERROR                      -30
+#define       LIBSLAS_MMAP_ERROR                       -31
+#define       LIBSLAS_INVALID_BUFFER_ERROR             -32
+#define       LIBSLAS_INCOMPATIBLE_FILES_ERROR         -33
+#define       LIBSLAS_MEMORY_ALLOCATION_ERROR          -34
+#define       LIBSLAS_READ_AHEAD_ERROR                 -35
+#define       LIBSLAS_IO_ENGINE_ERROR                  -36
+#define       LIBSLAS_INVALID_ADVICE_ERROR             -37
+#define       LIBSLAS_THREAD_ERROR                     -38
+#define       LIBSLAS_POINT_COUNT_ERROR                -39
+#define       LIBSLAS_VLR_NOT_FOUND_ERROR              -40
+#define       LIBSLAS_INDEX_ERROR                      -41
+#define       LIBSLAS_NO_GPS_TIME_ERROR                -42
 
 
   /*!
@@ -752,7 +856,8 @@ extern "C" {
       - LIBSLAS Point Data structure.  Key definitions are as follows:
 
           - (c) = Defined by the application program at creation time.
-          - (m) = Modifiable by the application program using the libslas_update_point_data function.
+          - (m) = Modifiable by the application program using the libslas_update_point_data,
+                  libslas_update_point_data_fields, or libslas_update_point_data_batch functions.
   */
 
   typedef struct
@@ -783,17 +888,128 @@ extern "C" {
 
 
 
+  /*!
+
+      - LIBSLAS point data column structure used by libslas_read_point_columns.  Each field is a pointer to an application
+        allocated array with room for at least the number of records being read.  Any field that is set to NULL is skipped.
+        The fields have the same meaning as the fields of the LIBSLAS_POINT_DATA structure.
+  */
+
+  typedef struct
+  {
+    double                      *x;
+    double                      *y;
+    float                       *z;
+    uint16_t                    *intensity;
+    uint8_t                     *return_number;
+    uint8_t                     *number_of_returns;
+    uint8_t                     *scan_direction_flag;
+    uint8_t                     *edge_of_flightline;
+    uint8_t                     *classification;
+    uint8_t                     *withheld;
+    uint8_t                     *key_point;
+    uint8_t                     *synthetic;
+    int8_t                      *scan_angle_rank;
+    uint8_t                     *user_data;
+    uint16_t                    *point_source_id;
+    double                      *gps_time;
+    uint16_t                    *red;
+    uint16_t                    *green;
+    uint16_t                    *blue;
+  } LIBSLAS_POINT_COLUMNS;
+
+
+
+  /*!
+
+      - LIBSLAS point update structure used by libslas_update_point_data_batch.  Only the (m) fields of the record are
+        written (see LIBSLAS_POINT_DATA).
+  */
+
+  typedef struct
+  {
+    int32_t                     recnum;                             /*!< Record number of the LAS point data record to be updated (starts at 0)  */
+    LIBSLAS_POINT_DATA          record;                             /*!< The new values for the modifiable fields  */
+  } LIBSLAS_POINT_UPDATE;
+
+
+
+  /*!
+
+      - LIBSLAS zone map filter structure used by libslas_query_zone_map.  Only the tests for the fields that are set in
+        fields (LIBSLAS_FIELD_X, LIBSLAS_FIELD_Y, LIBSLAS_FIELD_Z, LIBSLAS_FIELD_INTENSITY, LIBSLAS_FIELD_CLASSIFICATION,
+        and LIBSLAS_FIELD_RETURN_NUMBER) are used.  The ranges are inclusive.
+  */
+
+  typedef struct
+  {
+    uint32_t                    fields;                             /*!< Which of the tests below to use (LIBSLAS_FIELD_* values OR'ed together)  */
+    double                      min_x;                              /*!< Minimum X  */
+    double                      max_x;                              /*!< Maximum X  */
+    double                      min_y;                              /*!< Minimum Y  */
+    double                      max_y;                              /*!< Maximum Y  */
+    double                      min_z;                              /*!< Minimum Z  */
+    double                      max_z;                              /*!< Maximum Z  */
+    uint16_t                    min_intensity;                      /*!< Minimum intensity  */
+    uint16_t                    max_intensity;                      /*!< Maximum intensity  */
+    uint32_t                    classification;                     /*!< Bit n set to accept classification n (e.g. 1 << 2 for ground)  */
+    uint8_t                     return_number;                      /*!< Bit n set to accept return number n  */
+  } LIBSLAS_ZONE_FILTER;
+
+
+
+  /*!
+
+      - Callback function used by libslas_parallel_scan.  It is called from the worker threads with each batch of decoded
+        records:
+          - thread = Worker number (0 to nthreads - 1)
+          - recnum = Record number of the first record in the batch
+          - count = Number of records in the batch
+          - records = The decoded records (only good until the callback returns)
+          - user_ctx = Whatever you passed to libslas_parallel_scan
+      - Return 0 to keep going or anything else to stop the scan.
+  */
+
+  typedef int32_t (*LIBSLAS_SCAN_CALLBACK) (int32_t thread, int32_t recnum, int32_t count, LIBSLAS_POINT_DATA *records, void *user_ctx);
+
+
+
   /*!  LIBSLAS Public function declarations.  */
 
   int32_t libslas_open_las_file (char *path, LIBSLAS_HEADER *header, int32_t mode);
   int32_t libslas_create_las_file (char *path, LIBSLAS_HEADER *header);
+  int32_t libslas_create_las_file_hint (char *path, LIBSLAS_HEADER *header, int32_t expected_points);
   int32_t libslas_close_las_file (int32_t hnd);
   int32_t libslas_read_vlr_header (int32_t hnd, int32_t recnum, LIBSLAS_VLR_HEADER *vlr_header);
   int32_t libslas_read_vlr_data (int32_t hnd, int32_t recnum, uint8_t *vlr_data);
+  int32_t libslas_find_vlr (int32_t hnd, char *user_id, uint16_t record_id, LIBSLAS_VLR_HEADER *vlr_header);
   int32_t libslas_append_vlr_record (int32_t hnd, LIBSLAS_VLR_HEADER *vlr_header, uint8_t *vlr_data);
   int32_t libslas_read_point_data (int32_t hnd, int32_t recnum, LIBSLAS_POINT_DATA *record);
+  int32_t libslas_read_point_data_range (int32_t hnd, int32_t recnum, int32_t count, LIBSLAS_POINT_DATA *records);
+  int32_t libslas_read_point_columns (int32_t hnd, int32_t recnum, int32_t count, LIBSLAS_POINT_COLUMNS *columns);
+  int32_t libslas_read_point_data_fields (int32_t hnd, int32_t recnum, int32_t count, LIBSLAS_POINT_DATA *records, uint32_t fields);
+  int32_t libslas_read_point_data_batch (int32_t hnd, int32_t count, int32_t *recnums, LIBSLAS_POINT_DATA *records);
   int32_t libslas_append_point_data (int32_t hnd, LIBSLAS_POINT_DATA *record);
   int32_t libslas_update_point_data (int32_t hnd, int32_t recnum, LIBSLAS_POINT_DATA *record);
+  int32_t libslas_update_point_data_fields (int32_t hnd, int32_t recnum, LIBSLAS_POINT_DATA *record, uint32_t fields);
+  int32_t libslas_update_point_data_batch (int32_t hnd, int32_t count, LIBSLAS_POINT_UPDATE *updates);
+  int32_t libslas_read_raw_point_data (int32_t hnd, int32_t recnum, int32_t count, uint8_t *data);
+  int32_t libslas_append_raw_point_data (int32_t hnd, int32_t count, uint8_t *data);
+  int32_t libslas_declare_point_count (int32_t hnd, int32_t count);
+  int32_t libslas_write_point_data (int32_t hnd, int32_t recnum, int32_t count, LIBSLAS_POINT_DATA *records);
+  int32_t libslas_copy_point_data (int32_t src_hnd, int32_t dst_hnd, int32_t recnum, int32_t count);
+  int32_t libslas_set_io_buffer (int32_t hnd, uint8_t *buffer, int32_t size);
+  int32_t libslas_set_read_ahead (int32_t hnd, uint8_t *buffer, int32_t size);
+  int32_t libslas_set_io_engine (int32_t hnd, int32_t engine);
+  int32_t libslas_advise (int32_t hnd, int32_t recnum, int32_t count, int32_t pattern);
+  int32_t libslas_parallel_scan (char *path, int32_t nthreads, LIBSLAS_SCAN_CALLBACK callback, void *user_ctx);
+  int32_t libslas_build_spatial_index (int32_t hnd);
+  int32_t libslas_query_bbox (int32_t hnd, double xmin, double ymin, double xmax, double ymax, int32_t max_runs, int32_t *runs);
+  int32_t libslas_query_time_window (int32_t hnd, double t0, double t1, int32_t max_runs, int32_t *runs);
+  int32_t libslas_check_time_sorted (int32_t hnd);
+  int32_t libslas_find_time (int32_t hnd, double t);
+  int32_t libslas_build_zone_map (int32_t hnd);
+  int32_t libslas_query_zone_map (int32_t hnd, LIBSLAS_ZONE_FILTER *filter, int32_t max_runs, int32_t *runs);
 
   char *libslas_strerror ();
   void libslas_perror ();
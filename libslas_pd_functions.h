@@ -55,16 +55,17 @@ static void libslas_clean_exit (int32_t ret)
 {
   int32_t i;
 
-  for (i = 0 ; i < LIBSLAS_MAX_FILES ; i++)
+  for (i = 0 ; i < las_chunks * LIBSLAS_CHUNK_SIZE ; i++)
     {
-      /*  If we were in the process of creating a file we need to remove it since it isn't finished.  */
+      /*  If we were in the process of creating a file we need to remove it since it isn't finished.  Files that were
+          opened LIBSLAS_APPEND are left alone, their header still describes the records that were there before.  */
 
-      if (las[i].fp != NULL)
+      if (LAS (i).fp != NULL)
         {
-          if (las[i].created)
+          if (LAS (i).created)
             {
-              fclose (las[i].fp);
-              remove (las[i].path);
+              fclose (LAS (i).fp);
+              remove (LAS_COLD (i).path);
             }
         }
     }
@@ -40,7 +40,7 @@
 
 #ifndef LIBSLAS_VERSION
 
-#define     LIBSLAS_VERSION     "libslas library V1.0.0 - 07/16/14"
+#define     LIBSLAS_VERSION     "libslas library V1.1.0 - 10/16/26"
 
 #endif
 
@@ -53,4 +53,61 @@
 
     First working version.
 
+
+    Version 1.10
+    10/16/26
+
+    Added libslas_read_point_data_range to read a block of consecutive point records with a single read.
+    Added the LIBSLAS_READONLY_MMAP open mode to memory map the point data block.
+    Added libslas_set_io_buffer so appended point records can be staged in an application supplied buffer and
+    written in large, aligned chunks.  The file position is now tracked instead of asking ftello64 after every record.
+    Added libslas_read_point_columns to read point records into separate column arrays.
+    Added libslas_read_point_data_fields to unpack only the requested fields (LIBSLAS_FIELD_* bit mask) of point records.
+    Added libslas_read_raw_point_data and libslas_append_raw_point_data to copy packed point records between files without
+    unpacking and rescaling them.
+    Added libslas_copy_point_data to copy a range of point records between files with copy_file_range/sendfile on Linux.
+    Added libslas_update_point_data_batch to update many scattered point records with coalesced block read-modify-writes.
+    Added libslas_update_point_data_fields to write only the bytes holding the selected modifiable fields of a point record.
+    All point data I/O now uses pread/pwrite on the file descriptor so point reads no longer touch any shared file position
+    and any number of threads can read point data through the same handle.
+    Error information is now kept per thread and successful calls no longer write to it.
+    Replaced the fixed 64 entry handle table with one that grows 64 handles at a time (up to LIBSLAS_MAX_FILES) and hands
+    out handles from a free list under a lock so open/create/close are thread safe.  The path and memory map information
+    were moved out of the per handle structure used for point I/O.
+    Added libslas_set_read_ahead which starts a background thread that reads large blocks of point records ahead of the
+    application on a LIBSLAS_READONLY file (not available on Windows).
+    Added libslas_read_point_data_batch and libslas_set_io_engine.  With the LIBSLAS_IO_URING engine batches of scattered
+    point reads and updates are submitted through a Linux io_uring, falling back to pread/pwrite when that isn't available.
+    Added the LIBSLAS_READONLY_DIRECT open mode which reads the point data with O_DIRECT so big one pass scans don't
+    flush the page cache.
+    Added libslas_advise which passes access pattern hints for a range of point records on to posix_fadvise/madvise and
+    the read-ahead thread.
+    Added libslas_parallel_scan which reads and decodes a whole file in batches on a pool of worker threads and hands the
+    batches to an application callback.
+    Added libslas_declare_point_count and libslas_write_point_data so that multiple threads can write disjoint ranges of
+    point records to a new file at computed offsets.  Per-thread extents and counts by return are merged at close.
+    Added libslas_create_las_file_hint which preallocates a new file (fallocate) for an expected number of point records
+    and truncates the unused space at close.
+    The VLR headers are now read (usually in one read) when a file is opened and kept in a per-handle directory.
+    Fixed the VLR chain walk which didn't skip the VLR headers.  Added libslas_find_vlr to look up a VLR by user ID and
+    record ID.
+    Added the LIBSLAS_APPEND open mode so that point records can be appended to an existing file.  The header counts and
+    bounds are updated incrementally and rewritten at close.
+    Added libslas_build_spatial_index which writes a grid index of record runs to a .lsi sidecar file and
+    libslas_query_bbox which uses it to find the records in a bounding box without reading the whole file.
+    Added libslas_query_time_window which finds the records in a GPS time window using a per-chunk minimum/maximum GPS
+    time index that is built the first time it's needed and cached in the handle.
+    Added libslas_check_time_sorted, which finds out (in the same pass that builds the GPS time index) whether a file is
+    in GPS time order, and libslas_find_time, which binary searches a time ordered file for a GPS time.
+    Added libslas_build_zone_map which writes the X/Y/Z and intensity ranges and the classifications and return numbers
+    of every 65536 point records to a .lsz sidecar file and libslas_query_zone_map which uses it to skip the chunks that
+    can't match a filter.
+    Fixed libslas_read_point_data (and libslas_read_point_data_range, libslas_read_point_data_batch, and
+    libslas_parallel_scan, which use the same decoder) which dropped the high bit of the return number so returns 4 and 5
+    came back as 0 and 1.
+    The spatial index sidecar now saves the size and modification time of the LAS file and isn't used if either one
+    changes (a file rewritten or re-sorted by another program used to pass if it kept the same point count and bounds).
+    The zone map sidecar saves the same size and modification time check, so the point update functions no longer
+    delete it (a change made by another program or another handle is now caught too).
+
 </pre>*/